@@ -86,7 +86,7 @@ SoilNameDict soilnameDict;
 bool Engine::EngineInit(map<int, bool> errormap)
 {
     soilGrid = new SoilGrid(SIDE_LENGTH, SIDE_LENGTH, 0);
-    soilGrid->initGridWithPlant("Fescue grass");
+    soilGrid->initGridWithPlant("fescue grass");
 
     font = al_load_ttf_font("malgun.ttf", 16, 0);
 
@@ -123,7 +123,8 @@ bool Engine::EngineInit(map<int, bool> errormap)
     for (int y = 0; y < soilGrid->getHeight(); y++)
     for (int x = 0; x < soilGrid->getWidth(); x++)
     {
-        double waterlevel = soilGrid->ref(x, y).inspectWater().back();
+        const SoilCell& cell = soilGrid->get(x, y);
+        double waterlevel = cell.inspectWater(cell.getLayerCount() - 1);
         buffer = ColorMath::lerp(black, blue, waterlevel / 200.0f);
         al_put_pixel(x, y, buffer);
     }
@@ -160,7 +161,7 @@ void Engine::Update()
         WeatherModule->step();
         soilGrid->step(WeatherModule->getDataBundle());
         soilGrid->stepPlants(WeatherModule->getDataBundle());
-        soilGrid->stepSurfaceFlow(WeatherModule->getDataBundle(), 1.0);
+        soilGrid->routeSurfaceFlow(WeatherModule->getDataBundle());
         
         cout << soilGrid->ref(0, 0).surfaceWater << "\n";
         
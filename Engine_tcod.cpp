@@ -41,6 +41,8 @@ bool Engine::EngineInit()
 
     sg = new ALMANAC::SoilGrid(width, height);
     sg->initGridWithPlant("fescue grass");
+    int cores = std::thread::hardware_concurrency();
+    sg->setWorkerCount(cores > 1 ? cores - 1 : 0); // The thread running stepAll() does its share too.
 
     WeatherModule = new ALMANAC::Weather(true);
     WeatherModule->changeDate(ALMANAC::Month(MARCH, 2, 2013));
@@ -37,7 +37,7 @@ void MapScreen::redraw()
     for (int xcounter = 0; xcounter < sg->getWidth(); xcounter++)
     for (int ycounter = 0; ycounter < sg->getHeight(); ycounter++)
     {
-        auto c = sg->ref(xcounter, ycounter);
+        const ALMANAC::SoilCell& c = sg->get(xcounter, ycounter);
         int character = soilDict.getIcon(c.getTopsoilGroup());
         TCODColor fore = soilDict.getFrontColor(c.getTopsoilGroup());
         TCODColor back = soilDict.getBackColor(c.getTopsoilType());
@@ -148,7 +148,7 @@ std::vector<ColoredMessage> MapScreen::getListing(coord screenCoords)
 {
     coord abscoord = AbsoluteFromScreenCoords(screenCoords);
     std::vector<ColoredMessage> messages;
-    if (sg && &sg->ref(abscoord.first, abscoord.second) != &sg->null) // If sg exists & the cell exists
+    if (sg && sg->inBounds(abscoord.first, abscoord.second)) // If sg exists & the cell exists
     {
         auto& cell = sg->ref(abscoord.first, abscoord.second);
         auto soilgroup = cell.getTopsoilGroup();
@@ -157,7 +157,7 @@ std::vector<ColoredMessage> MapScreen::getListing(coord screenCoords)
         TCODColor fore = soilDict.getBackColor(soiltype);
         messages.push_back(ColoredMessage(soilname, fore));
 
-        for (auto plant : sg->ref(abscoord.first, abscoord.second).plants)
+        for (auto& plant : cell.plants)
         {
             auto RGB = plant.vp.getColor();
             TCODColor myColor(RGB.r, RGB.g, RGB.b);
@@ -168,13 +168,14 @@ std::vector<ColoredMessage> MapScreen::getListing(coord screenCoords)
             messages.push_back(ColoredMessage(name, myColor, back));
         }
 
-        for (auto seed : sg->ref(abscoord.first, abscoord.second).items)
+        for (auto& item : cell.items)
         {
-            auto RGB = seed.second.getColor();
+            HerbSim::Seed seed = sg->getItemSeed(abscoord.first, abscoord.second, item);
+            auto RGB = seed.prop.vp.getColor();
             TCODColor myColor(RGB.r, RGB.g, RGB.b);
-            std::string name = seed.second.getName();
+            std::string name = seed.getName(item.count);
             TCODColor back(255, 0, 255);
-            if (seed.second[0].prop.vp.whiteBackground)
+            if (seed.prop.vp.whiteBackground)
                 back = TCODColor::white;
             messages.push_back(ColoredMessage(name, myColor, back));
         }
@@ -0,0 +1,87 @@
+#include "canopy.h"
+#include "plant.h"
+#include <cmath>
+#include <iostream>
+#include <cstdlib>
+
+using namespace ALMANAC;
+
+CanopyProfile::CanopyProfile()
+: height(0), layersVersion(0)
+{
+}
+
+Canopy::Canopy()
+: heightTolerance(0), version(1)
+{
+    boundaries = { 0.0, 300, 600, 1000, 2000, 3000, 5000, 2000000 }; // does not simulate heights larger than 2 km
+}
+
+void Canopy::setLayers(const std::vector<double>& newBoundaries)
+{
+    if (newBoundaries.size() < 2 || newBoundaries.size() > maxCanopyLayers + 1)
+    {
+        std::cerr << "Canopy needs between 1 and " << maxCanopyLayers << " layers, got " << (int)newBoundaries.size() - 1 << ".";
+        abort();
+    }
+    boundaries = newBoundaries;
+    version++;
+}
+
+int Canopy::getLayerCount() const
+{
+    return boundaries.size() - 1;
+}
+
+void Canopy::setHeightTolerance(const double& tolerance)
+{
+    heightTolerance = tolerance;
+}
+
+void Canopy::updateProfile(BasePlant& plant) const
+{
+    CanopyProfile& profile = plant.canopyProfile;
+    const double height = plant.calcHeight();
+    if (profile.layersVersion == version && std::abs(height - profile.height) <= heightTolerance)
+        return;
+
+    profile.area.clear();
+    for (int counter = boundaries.size() - 1; counter >= 1; counter--)
+        profile.area.push_back(plant.species().LAIGraph.getPositiveArea(boundaries[counter - 1], boundaries[counter], height));
+    profile.height = height;
+    profile.layersVersion = version;
+}
+
+void Canopy::shareLight(std::vector<BasePlant>& plants, const double& radiation, std::vector<double>& rad) const
+{
+    const double groundFraction = 1.0;
+    rad.assign(plants.size(), 0);
+    for (BasePlant& plant : plants)
+    {
+        updateProfile(plant);
+        plant.canopyLAI = plant.getLAI();
+    }
+
+    double totalRad = radiation;
+    const int layers = getLayerCount();
+    for (int layer = 0; layer < layers; layer++) // From the top down.
+    {
+        double consumedRad = 0;
+        double totalLAI = layer == layers - 1 ? 0.01 : groundFraction;
+        for (BasePlant& plant : plants)
+        {
+            if (plant.isDead())
+                continue;
+            totalLAI += plant.canopyLAI * plant.canopyProfile.area[layer]; // Add up the total LAI in the layer
+        }
+
+        for (int counter = 0; counter < (int)plants.size(); counter++)
+        {
+            // Give each plant its fraction of the radiation.
+            double deltaRad = totalRad * plants[counter].canopyLAI * plants[counter].canopyProfile.area[layer] / totalLAI;
+            rad[counter] += deltaRad;
+            consumedRad += deltaRad;
+        }
+        totalRad -= consumedRad; // Subtract the total taken rad and repeat.
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <vector>
+#include "inlineVector.h"
+
+namespace ALMANAC
+{
+    class BasePlant;
+
+    const int maxCanopyLayers = 16;
+
+    /**
+    How much of a plant's leaf area is in each layer of the canopy. Only depends on the plant's height and the
+    layers, so a plant keeps it and it is only rebuilt when one of them changes.
+    **/
+    struct CanopyProfile
+    {
+        CanopyProfile();
+        InlineVector<double, maxCanopyLayers> area; // Fraction of the leaves in each layer, top layer first.
+        double height; // mm, the height it was built for.
+        unsigned int layersVersion; // Canopy::version it was built for, 0 if never built.
+    };
+
+    /**
+    Splits the light reaching a cell between its plants. The air above the ground is cut into layers;
+    going from the top layer down, each plant takes a share of what is left in proportion to its leaf area
+    in that layer, and the ground counts as a little leaf area too.
+    **/
+    class Canopy
+    {
+    public:
+        Canopy(); // Layers at 0, 300, 600, 1000, 2000, 3000 and 5000 mm.
+        // Layer boundaries in mm, ascending and starting at 0. The last one is the top of the highest layer.
+        void setLayers(const std::vector<double>& boundaries);
+        int getLayerCount() const;
+        // Profiles are rebuilt once a plant's height moves more than this, in mm. 0 rebuilds on any change.
+        void setHeightTolerance(const double& tolerance);
+
+        // Fills rad with the radiation each plant gets, in the same order as plants.
+        void shareLight(std::vector<BasePlant>& plants, const double& radiation, std::vector<double>& rad) const;
+
+    private:
+        void updateProfile(BasePlant& plant) const;
+
+        std::vector<double> boundaries;
+        double heightTolerance;
+        unsigned int version; // Changes with the layers, so every profile gets rebuilt.
+    };
+}
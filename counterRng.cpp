@@ -0,0 +1,51 @@
+#include "counterRng.h"
+
+using namespace ALMANAC;
+
+// Round multipliers and key increments from Salmon et al., "Parallel random numbers: as easy as 1, 2, 3".
+static const uint32_t philoxM0 = 0xD2511F53, philoxM1 = 0xCD9E8D57;
+static const uint32_t philoxW0 = 0x9E3779B9, philoxW1 = 0xBB67AE85;
+static const int philoxRounds = 10;
+
+CounterRNG::CounterRNG(const unsigned int& seed, const unsigned int& stream1, const unsigned int& stream2)
+{
+    key[0] = seed;
+    key[1] = 0x3C6EF372; // Keeps a seed of 0 from being a zero key.
+    stream[0] = stream1;
+    stream[1] = stream2;
+}
+
+void CounterRNG::philox(uint32_t counter[4]) const
+{
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < philoxRounds; round++)
+    {
+        uint64_t product0 = (uint64_t)philoxM0 * counter[0];
+        uint64_t product1 = (uint64_t)philoxM1 * counter[2];
+        uint32_t next0 = (uint32_t)(product1 >> 32) ^ counter[1] ^ k0;
+        uint32_t next2 = (uint32_t)(product0 >> 32) ^ counter[3] ^ k1;
+        counter[0] = next0;
+        counter[1] = (uint32_t)product1;
+        counter[2] = next2;
+        counter[3] = (uint32_t)product0;
+        k0 += philoxW0;
+        k1 += philoxW1;
+    }
+}
+
+unsigned int CounterRNG::get(const unsigned int& step, const unsigned int& draw) const
+{
+    uint32_t counter[4] = { stream[0], stream[1], step, draw };
+    philox(counter);
+    return counter[0];
+}
+
+double CounterRNG::uniform(const unsigned int& step, const unsigned int& draw, const double& min, const double& max) const
+{
+    uint32_t counter[4] = { stream[0], stream[1], step, draw };
+    philox(counter);
+    // 53 random bits, the most a double holds.
+    uint64_t bits = ((uint64_t)counter[0] << 21) ^ (counter[1] >> 11);
+    double unit = bits * (1.0 / 9007199254740992.0); // 2^53
+    return min + (max - min) * unit;
+}
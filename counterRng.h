@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+
+namespace ALMANAC
+{
+    /**
+    A counter-based random number generator (Philox4x32-10). Instead of an engine with state that every draw
+    advances, a draw is a pure function of the generator's seed and stream and of the (step, draw) pair asked for.
+    The same plant on the same day always gets the same numbers, whichever thread runs it and in whatever order,
+    and the whole generator is 16 bytes.
+    **/
+    class CounterRNG
+    {
+    public:
+        CounterRNG(const unsigned int& seed = 0, const unsigned int& stream1 = 0, const unsigned int& stream2 = 0);
+
+        unsigned int get(const unsigned int& step, const unsigned int& draw) const; // 32 random bits.
+        double uniform(const unsigned int& step, const unsigned int& draw, const double& min = 0, const double& max = 1) const; // In [min, max).
+
+    private:
+        void philox(uint32_t counter[4]) const; // Scrambles the counter in place.
+
+        uint32_t key[2];
+        uint32_t stream[2];
+    };
+}
@@ -23,7 +23,7 @@ Parabola::Parabola()
 }
 
 // w * (x - p)^2 + v
-double Parabola::getValue(const double& x)
+double Parabola::getValue(const double& x) const
 {
     return width * pow(x - parallel, 2) + vertical;
 }
@@ -78,7 +78,7 @@ LeafDistribution::LeafDistribution(bool IsLine)
     p = 1;
 }
 
-double LeafDistribution::getIntegral(double x)
+double LeafDistribution::getIntegral(double x) const
 {
     
     // for f(x) = p(ax^2 + bx + c)
@@ -86,7 +86,7 @@ double LeafDistribution::getIntegral(double x)
     return 1 / 3.0 * p * a * pow(x, 3) + 0.5 * p * b * pow(x, 2) + p * c * x;    
 }
 
-double LeafDistribution::getPositiveArea(double x1, double x2)
+double LeafDistribution::getPositiveArea(double x1, double x2) const
 {
     if (x1 > x2)
     {
@@ -106,7 +106,7 @@ double LeafDistribution::getPositiveArea(double x1, double x2)
     return getIntegral(x2) - getIntegral(x1);
 }
 
-double LeafDistribution::getPositiveArea(double x1, double x2, double plantHeight)
+double LeafDistribution::getPositiveArea(double x1, double x2, double plantHeight) const
 {
     if (plantHeight == 0)
     {
@@ -131,7 +131,7 @@ SCurve::SCurve()
 : scale(0), horiz(0), vert(0)
 {}
 
-double SCurve::getValue(const double& x)
+double SCurve::getValue(const double& x) const
 {
     return up + vert / (1 + exp(-scale * (x - horiz)));
 }
\ No newline at end of file
@@ -12,7 +12,7 @@ struct Parabola
 public:
     Parabola(double root1, const double& vertexX, const double& vertexY);
     Parabola();
-    double getValue(const double& x);
+    double getValue(const double& x) const;
 
     double width;
     double parallel;
@@ -37,13 +37,13 @@ public:
     
     double p, a, b, c;
     double leftRoot, rightRoot;
-    double getPositiveArea(double x1, double x2); // 0 <= x1, x2 <= 1
+    double getPositiveArea(double x1, double x2) const; // 0 <= x1, x2 <= 1
     // Automatically swaps x1 and x2 if x1 > x2. Negative area is ignored.
-    double getPositiveArea(double x1, double x2, double plantHeight); 
+    double getPositiveArea(double x1, double x2, double plantHeight) const; 
     // this function simply divides x1, x2 by plantHeight and plugs into getPositiveArea(x1, x2)
 
 private:
-    double getIntegral(double x); // for function f(x) gets F(x), assuming C = 0
+    double getIntegral(double x) const; // for function f(x) gets F(x), assuming C = 0
 };
 
 namespace ALMANAC
@@ -76,5 +76,5 @@ struct SCurve
     SCurve();
     double scale, horiz, vert, up;
 
-    double getValue(const double& x);
+    double getValue(const double& x) const;
 };
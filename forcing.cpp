@@ -0,0 +1,46 @@
+#include "forcing.h"
+#include "plant.h"
+#include "plantDictionary.h"
+#include <cmath>
+#include <algorithm>
+
+using namespace ALMANAC;
+
+SpeciesForcing::SpeciesForcing()
+: CO2Factor(0), tempStress(0), leafShedTemp(0), floralInduction(0), vernalization(0)
+{
+}
+
+SpeciesForcing::SpeciesForcing(const SpeciesProperties& species, const WeatherData& wd)
+{
+    double averageTemp = (wd.maxTemp + wd.minTemp) / 2.0;
+    CO2Factor = species.CO2CurveFactors.getValue(wd.CO2);
+    tempStress = species.tempCurve.getValue(averageTemp);
+    leafShedTemp = species.tempCurve.getValue(wd.maxTemp);
+    floralInduction = species.flowerTempCurve.getValue(averageTemp) * species.nightLengthCurve.getValue(wd.nightLength);
+    vernalization = species.vernalizationCurve.getValue(averageTemp);
+}
+
+DailyForcing::DailyForcing(const WeatherData& wd)
+: weather(wd)
+{
+    averageTemp = (wd.maxTemp + wd.minTemp) / 2.0;
+    potentialEvaporation = 0.0032 * wd.radiation / 2.456 /*MJ/kg*/ * ((wd.maxTemp + wd.minTemp) / 2 + 17.8) * pow(wd.maxTemp - wd.minTemp, 0.6); // Hargreaves method.
+    VPD = BasePlant::findVPD((wd.maxTemp - wd.minTemp) / 2.0f, wd.humidity);
+
+    if (averageTemp > 0)
+        snowmeltFraction = std::min(1.0, log(averageTemp + 1.0) / log(10.0));
+    else
+        snowmeltFraction = 0.01;
+
+    species.reserve(PD.getSpeciesCount());
+    for (int counter = 0; counter < PD.getSpeciesCount(); counter++)
+        species.push_back(SpeciesForcing(PD.getSpecies(counter), wd));
+}
+
+const SpeciesForcing* DailyForcing::getSpecies(const int& speciesID) const
+{
+    if (speciesID < 0 || speciesID >= (int)species.size())
+        return 0;
+    return &species[speciesID];
+}
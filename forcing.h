@@ -0,0 +1,45 @@
+#pragma once
+#include "Weather.h"
+#include <vector>
+
+namespace ALMANAC
+{
+    struct SpeciesProperties;
+
+    /**
+    The values of a species' response curves for one day's weather. Plants of the same species share their
+    curves, so these only need to be worked out once a day per species instead of once a day per plant.
+    **/
+    struct SpeciesForcing
+    {
+        SpeciesForcing();
+        SpeciesForcing(const SpeciesProperties& species, const WeatherData& wd);
+
+        double CO2Factor; // CO2CurveFactors at the day's CO2
+        double tempStress; // tempCurve at the average temp
+        double leafShedTemp; // tempCurve at the max temp
+        double floralInduction; // flowerTempCurve at the average temp times nightLengthCurve at the night length
+        double vernalization; // vernalizationCurve at the average temp
+    };
+
+    /**
+    Everything in a day's weather that is the same for all cells and plants, computed once when the day starts
+    and handed down to them. Also holds the SpeciesForcing of every species in the plant dictionary.
+    **/
+    struct DailyForcing
+    {
+        DailyForcing(const WeatherData& wd);
+
+        // Returns the species' forcing, or 0 for properties that don't come from the plant dictionary.
+        const SpeciesForcing* getSpecies(const int& speciesID) const;
+
+        WeatherData weather;
+        double averageTemp; // C
+        double potentialEvaporation; // mm, Hargreaves method
+        double VPD; // kPa
+        double snowmeltFraction; // How much of the snow melts today.
+
+    private:
+        std::vector<SpeciesForcing> species;
+    };
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <type_traits>
+#include <new>
+#include <iostream>
+#include <cstdlib>
+
+namespace ALMANAC
+{
+    /**
+    A vector with a fixed capacity that keeps its elements inside the object itself, so a container of
+    them (like the grid's cells) needs no heap allocation per element. Only the parts of std::vector the
+    soil code uses are here. Going past the capacity is an error.
+    **/
+    template <typename T, int Capacity>
+    class InlineVector
+    {
+    public:
+        typedef T* iterator;
+        typedef const T* const_iterator;
+
+        InlineVector() : count(0) {}
+        InlineVector(const InlineVector& other) : count(0)
+        {
+            for (int counter = 0; counter < other.count; counter++)
+                push_back(other[counter]);
+        }
+        ~InlineVector()
+        {
+            clear();
+        }
+        InlineVector& operator=(const InlineVector& other)
+        {
+            if (this != &other)
+            {
+                clear();
+                for (int counter = 0; counter < other.count; counter++)
+                    push_back(other[counter]);
+            }
+            return *this;
+        }
+
+        void push_back(const T& value)
+        {
+            if (count >= Capacity)
+            {
+                std::cerr << "InlineVector is full, capacity " << Capacity << ".";
+                abort();
+            }
+            new (data() + count) T(value);
+            count++;
+        }
+        void pop_back()
+        {
+            count--;
+            data()[count].~T();
+        }
+        void clear()
+        {
+            while (count > 0)
+                pop_back();
+        }
+        void reserve(const int&) {} // Always has room for Capacity elements.
+
+        int size() const { return count; }
+        bool empty() const { return count == 0; }
+        static int capacity() { return Capacity; }
+
+        T& operator[](const int& index) { return data()[index]; }
+        const T& operator[](const int& index) const { return data()[index]; }
+        T& front() { return data()[0]; }
+        const T& front() const { return data()[0]; }
+        T& back() { return data()[count - 1]; }
+        const T& back() const { return data()[count - 1]; }
+
+        iterator begin() { return data(); }
+        iterator end() { return data() + count; }
+        const_iterator begin() const { return data(); }
+        const_iterator end() const { return data() + count; }
+
+    private:
+        T* data() { return reinterpret_cast<T*>(&storage); }
+        const T* data() const { return reinterpret_cast<const T*>(&storage); }
+
+        typename std::aligned_storage<sizeof(T) * Capacity, std::alignment_of<T>::value>::type storage;
+        int count;
+    };
+}
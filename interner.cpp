@@ -0,0 +1,30 @@
+#include "interner.h"
+
+using namespace ALMANAC;
+
+int StringInterner::intern(const std::string& text)
+{
+    auto existing = ids.find(text);
+    if (existing != ids.end())
+        return existing->second;
+    const int id = strings.size();
+    ids[text] = id;
+    strings.push_back(text);
+    return id;
+}
+
+int StringInterner::find(const std::string& text) const
+{
+    auto existing = ids.find(text);
+    return existing != ids.end() ? existing->second : -1;
+}
+
+const std::string& StringInterner::getString(const int& id) const
+{
+    return strings[id];
+}
+
+int StringInterner::size() const
+{
+    return strings.size();
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace ALMANAC
+{
+    /**
+    Hands out a small number for each distinct string, 0 for the first one interned and counting up. Anything
+    keyed by the string can keep the number instead, and looking it up is an integer compare.
+    **/
+    class StringInterner
+    {
+    public:
+        int intern(const std::string& text); // Its number, given a new one if the string wasn't seen before.
+        int find(const std::string& text) const; // -1 if the string was never interned.
+        const std::string& getString(const int& id) const;
+        int size() const;
+
+    private:
+        std::unordered_map<std::string, int> ids;
+        std::vector<std::string> strings; // Indexed by id
+    };
+}
@@ -26,7 +26,7 @@ string Item::amount_s()
 }*/
 
 
-Seed::Seed(ALMANAC::PlantProperties& sp, ALMANAC::PlantVisualProperties& vp)
+Seed::Seed(const ALMANAC::PlantProperties& sp, const ALMANAC::PlantVisualProperties& vp)
 {
     prop.pp = sp;
     prop.vp = vp;
@@ -37,54 +37,49 @@ string Seed::getName()
     return prop.vp.seedname;
 }
 
+string Seed::getName(const int& count)
+{
+    if (count > 1)
+        return to_string(count) + prop.vp.seedname_plural;
+    return prop.vp.seedname;
+}
+
 int c = 0; // Temporary fix to make every seed ID unique.
 SeedProperties::SeedProperties(ALMANAC::PlantProperties& properties)
 {
     this->itemtype = "seed";
     pp = properties;
-    this->name = pp.name + " seed";
+    this->name = pp.species().name + " seed";
     this->ID = this->name + " " + rightAlignNumber(c++);
 }
 
-
-MultiSeed::MultiSeed(const Seed& s)
+SeedItem::SeedItem(const int& species, const unsigned int& genes, const int& number)
+: speciesID(species), genome(genes), count(number)
 {
-    seeds.push_back(s);
 }
 
-MultiSeed::MultiSeed(ALMANAC::PlantProperties& sp, ALMANAC::PlantVisualProperties& vp)
+unsigned int GenomeBank::add(const ALMANAC::PlantProperties& pp, const ALMANAC::PlantVisualProperties& vp)
 {
-    *this = MultiSeed(Seed(sp, vp));
-}
-
-std::string MultiSeed::getName()
-{
-    if (seeds.size() > 1)
-    {
-        return to_string(seeds.size()) + seeds.front().prop.vp.seedname_plural;
-    }
-    else if (seeds.size() == 1)
+    const unsigned int hash = pp.genomeHash() ^ vp.lerpHash() * 31;
+    auto range = byHash.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
     {
-        return seeds.front().prop.vp.seedname;
+        const SeedProperties& entry = genomes[it->second].prop;
+        if (entry.pp.sameGenome(pp) && entry.vp.sameLook(vp))
+            return it->second;
     }
-    else
-        return "#ERROR";
-}
-
-int MultiSeed::getNumber()
-{
-    return seeds.size();
+    const unsigned int genome = genomes.size();
+    genomes.push_back(Seed(pp, vp));
+    byHash.insert(std::make_pair(hash, genome));
+    return genome;
 }
 
-ALMANAC::RGB MultiSeed::getColor()
+const Seed& GenomeBank::get(const unsigned int& genome) const
 {
-    return seeds.front().prop.vp.getColor();
+    return genomes[genome];
 }
 
-Seed& MultiSeed::operator[](const int& index)
+int GenomeBank::size() const
 {
-    if (seeds.size() > index)
-        return seeds[index];
-    else
-        throw std::out_of_range("seeds array out of bounds");
+    return genomes.size();
 }
\ No newline at end of file
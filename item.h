@@ -2,6 +2,7 @@
 #include <string>
 #include "plantproperties.h"
 #include <vector>
+#include <unordered_map>
 
 namespace HerbSim
 {
@@ -38,25 +39,40 @@ namespace HerbSim
     {
     public:
         Seed(){}
-        Seed(ALMANAC::PlantProperties& sp, ALMANAC::PlantVisualProperties& vp);
+        Seed(const ALMANAC::PlantProperties& sp, const ALMANAC::PlantVisualProperties& vp);
        // std::string tag;
         std::string getName();
+        std::string getName(const int& count); // For a pile of count of them.
         SeedProperties prop;    
 
 
     };
 
-    class MultiSeed
+    /**
+    A pile of seeds lying in a cell, all of one species and with the same genes. The genes are kept once in a
+    GenomeBank of the SoilGrid, so the pile is just three numbers however many seeds are in it.
+    **/
+    struct SeedItem
+    {
+        SeedItem(const int& species, const unsigned int& genes, const int& number);
+        int speciesID; // ALMANAC::SpeciesProperties::speciesID
+        unsigned int genome; // Index in the GenomeBank of the cell's row of tiles, see SoilGrid::getItemSeed()
+        int count;
+    };
+
+    /**
+    The genes and looks of SeedItems, each set stored once however many items share it. Entries are never removed,
+    so an item's index stays good. Not locked: each thread adds to its own bank.
+    **/
+    class GenomeBank
     {
     public:
-        MultiSeed(){}
-        MultiSeed(ALMANAC::PlantProperties& sp, ALMANAC::PlantVisualProperties& vp);
-        MultiSeed(const Seed& s);
-        Seed& operator[](const int& index);
-        //std::string tag;
-        std::string getName();
-        ALMANAC::RGB getColor();
-        int getNumber();
-        std::vector<Seed> seeds;
+        unsigned int add(const ALMANAC::PlantProperties& pp, const ALMANAC::PlantVisualProperties& vp); // Index of the entry with these genes and looks, added if new.
+        const Seed& get(const unsigned int& genome) const;
+        int size() const;
+
+    private:
+        std::vector<Seed> genomes;
+        std::unordered_multimap<unsigned int, unsigned int> byHash; // PlantProperties::genomeHash() and PlantVisualProperties::lerpHash() to index in genomes
     };
 }
\ No newline at end of file
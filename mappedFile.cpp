@@ -0,0 +1,114 @@
+#include "mappedFile.h"
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace ALMANAC;
+
+#ifdef _WIN32
+MappedFile::MappedFile()
+: view(0), length(0), file(INVALID_HANDLE_VALUE), mapping(0)
+{
+}
+#else
+MappedFile::MappedFile()
+: view(0), length(0), file(-1)
+{
+}
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+bool MappedFile::open(const std::string& filename)
+{
+    close();
+    file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        close();
+        return false;
+    }
+    mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+    if (mapping)
+        view = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        close();
+        return false;
+    }
+    length = (size_t)fileSize.QuadPart;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (view)
+        UnmapViewOfFile(view);
+    if (mapping)
+        CloseHandle(mapping);
+    if (file != INVALID_HANDLE_VALUE)
+        CloseHandle(file);
+    view = 0;
+    length = 0;
+    mapping = 0;
+    file = INVALID_HANDLE_VALUE;
+}
+#else
+bool MappedFile::open(const std::string& filename)
+{
+    close();
+    file = ::open(filename.c_str(), O_RDONLY);
+    if (file < 0)
+        return false;
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0)
+    {
+        close();
+        return false;
+    }
+    void* mapped = mmap(0, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (mapped == MAP_FAILED)
+    {
+        close();
+        return false;
+    }
+    view = (const char*)mapped;
+    length = info.st_size;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (view)
+        munmap((void*)view, length);
+    if (file >= 0)
+        ::close(file);
+    view = 0;
+    length = 0;
+    file = -1;
+}
+#endif
+
+const char* MappedFile::data() const
+{
+    return view;
+}
+
+size_t MappedFile::size() const
+{
+    return length;
+}
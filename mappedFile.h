@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+namespace ALMANAC
+{
+    /**
+    A whole file mapped into memory, read only. Nothing is copied up front; the OS pages the file in as it is read.
+    It is unmapped when the MappedFile goes away.
+    **/
+    class MappedFile
+    {
+    public:
+        MappedFile();
+        ~MappedFile();
+        bool open(const std::string& filename); // False if the file can't be mapped or is empty.
+        const char* data() const;
+        size_t size() const;
+
+    private:
+        MappedFile(const MappedFile&); // Owns the mapping, so no copies.
+        MappedFile& operator=(const MappedFile&);
+        void close();
+
+        const char* view;
+        size_t length;
+#ifdef _WIN32
+        void* file; // HANDLEs
+        void* mapping;
+#else
+        int file;
+#endif
+    };
+}
@@ -74,6 +74,11 @@ void MendelianInheritance::seed(const int& newseed)
   srand(newseed);
 }
 
+void MendelianInheritance::seedGenerator(const unsigned int& newseed)
+{
+  gen.seed(newseed);
+}
+
 int MendelianInheritance::random(const int& min, const int& max)
 {
  std::uniform_int_distribution<> distribution(min,max);
@@ -45,6 +45,7 @@ public:
   PolyGene inherit(const PolyGene& left, const PolyGene& right);
   // PolyGene's inheritance method is slightly different, but fundamentally identical.
   virtual void seed(const int& newseed); //Also inheritable.
+  void seedGenerator(const unsigned int& newseed); // Seeds what spawnInRange() and inherit() draw from, seed() only seeds rand().
   PolyGene spawnInRange(const double& min, const double& max); // Spawns a random PolyGene with all NumberGenes in range min to max, and MendelGenes randomly set.
   PolyGene spawnInRange(const std::pair<double, double>& range); // convenience function to use pair<>
   PolyGene spawnInRange(const std::pair<int, int>& range); // convenience function to use pair<>
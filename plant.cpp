@@ -17,65 +17,46 @@ using namespace ALMANAC;
 BasePlant::BasePlant(SoilCell* soil)
 : Biomass(0.05, 0, 0, 0), LAI(0), prevLAI(0), previousHeatUnits(0), heatUnits(0), soilPatch(soil), requiredWater(1), suppliedWater(1), height(0)
 , currentWaterlogValue(0), nitrogen(0), floralInductionUnits(0), tempstress(1), rootDepth(0), dead(false), deadBiomass(0), maxBiomass(0), removedNitrogen(0), consecutiveDormantDays(0),
-vernalizationUnits(0), age(0), daysLeftForShedding(0), readyForLeafShed(false)
+vernalizationUnits(0), age(0), daysLeftForShedding(0), readyForLeafShed(false), canopyLAI(0), heatUnitsToday(0), sleepEnd(0)
 {
     maxBiomass = Biomass;
     *this = BasePlant(PD.getPlant("fescue grass"), PD.getVisual("fescue grass"), soil);
-    rng.seed(rand());
 }
 
 BasePlant::BasePlant(PlantProperties plantprop, PlantVisualProperties visualprop, SoilCell* soil)
 : LAI(0), prevLAI(0), previousHeatUnits(0), heatUnits(0), soilPatch(soil), requiredWater(1), suppliedWater(1), height(0)
 , currentWaterlogValue(0), nitrogen(0), floralInductionUnits(0), tempstress(1), rootDepth(0), dead(false), REG(0), deadBiomass(0), removedNitrogen(0), consecutiveDormantDays(0),
-vernalizationUnits(0), age(0), daysLeftForShedding(0), readyForLeafShed(false)
+vernalizationUnits(0), age(0), daysLeftForShedding(0), readyForLeafShed(false), canopyLAI(0), heatUnitsToday(0), sleepEnd(0)
 {
     prop = plantprop;
     vp = visualprop;
     Biomass = BiomassHolder(prop.averageFruitWeight() * prop.seedRatio() / 10, 0, 0, 0);
     maxBiomass = Biomass;
 
-    nitrogen = findRequiredNitrogen();
+    floweringHU = species().growthStages.at(6);
+    endFloweringHU = species().growthStages.at(7);
+    finalHU = species().growthStages.at(9);
+    maxHU = species().growthStages.at(10);
 
-    floweringHU = prop.growthStages[6];
-    endFloweringHU = prop.growthStages[7];
-    finalHU = prop.growthStages[9];
-    maxHU = prop.growthStages[10];
-    prop.nightLengthCurve = getSCurve(prop.dayNeutral, prop.longDayPlant, prop.minimumInduction, prop.criticalNightLength);
-
-    rng.seed(rand());
+    nitrogen = findRequiredNitrogen(); // Needs floweringHU.
 }
 
-BasePlant::BasePlant(Seed seed, SoilCell* soil)
+BasePlant::BasePlant(const SeedCohort& seeds, SoilCell* soil)
 : LAI(0), prevLAI(0), previousHeatUnits(0), heatUnits(0), soilPatch(soil), requiredWater(1), suppliedWater(1), height(0)
 , currentWaterlogValue(0), nitrogen(0), floralInductionUnits(0), tempstress(1), rootDepth(0), dead(false), REG(0), deadBiomass(0), removedNitrogen(0), consecutiveDormantDays(0),
-vernalizationUnits(0), age(0), daysLeftForShedding(0), readyForLeafShed(false)
+vernalizationUnits(0), age(0), daysLeftForShedding(0), readyForLeafShed(false), canopyLAI(0), heatUnitsToday(0), sleepEnd(0)
 {
-    prop = seed.pp;
-    vp = seed.vp;
-    Biomass = BiomassHolder(seed.seedBiomass / 10.0, 0, 0, 0);
+    prop = seeds.pp;
+    vp = seeds.vp;
+    Biomass = BiomassHolder(seeds.averageSeedBiomass() / 10.0, 0, 0, 0);
     maxBiomass = Biomass;
 
-    nitrogen = findRequiredNitrogen();
-
-    floweringHU = prop.growthStages[6];
-    endFloweringHU = prop.growthStages[7];
-    finalHU = prop.growthStages[9];
-    maxHU = prop.growthStages[10];
+    floweringHU = species().growthStages.at(6);
+    endFloweringHU = species().growthStages.at(7);
+    finalHU = species().growthStages.at(9);
+    maxHU = species().growthStages.at(10);
 
-    rng.seed(rand());
-}
-
-double BasePlant::random(double min, double max)
-{
-    if (min > max)
-    {
-        double temp = min;
-        min = max;
-        max = min;
-    }
-
-    uniform_real_distribution<> dist(min, max);
-    return dist(rng);
+    nitrogen = findRequiredNitrogen(); // Needs floweringHU.
 }
 
 SCurve BasePlant::getSCurve(const bool dayNeutral, const bool longDayPlant, double minInduction, const double& optimalInductionNightLength)
@@ -110,28 +91,60 @@ void BasePlant::findREG()
 
 void BasePlant::calculate(const WeatherData& data, const double& albedo, const double radiation)
 {
+    calculate(DailyForcing(data), albedo, radiation);
+}
+
+template <int LifeForm>
+void BasePlant::calculateAs(const DailyForcing& forcing, const double radiation)
+{
+    const SpeciesForcing today = getSpeciesForcing(forcing);
+    if (startDayAs<LifeForm>(forcing, today))
+    {
+        takeFromSoil(forcing);
+        growAs<LifeForm>(forcing, today, radiation);
+    }
+}
+
+void BasePlant::calculate(const DailyForcing& forcing, const double& albedo, const double radiation)
+{
+    typedef void (BasePlant::*Kernel)(const DailyForcing&, const double);
+    static const Kernel kernels[lfCOMBINATIONS] = LIFEFORM_KERNELS(BasePlant::calculateAs);
+    (this->*kernels[species().lifeForm])(forcing, radiation);
+}
+
+SpeciesForcing BasePlant::getSpeciesForcing(const DailyForcing& forcing)
+{
+    // Plants whose properties aren't from the dictionary have no shared entry, so work theirs out here.
+    const SpeciesForcing* shared = forcing.getSpecies(species().speciesID);
+    return shared ? *shared : SpeciesForcing(species(), forcing.weather);
+}
+
+template <int LifeForm>
+bool BasePlant::startDayAs(const DailyForcing& forcing, const SpeciesForcing& today)
+{
+    const WeatherData& data = forcing.weather;
     age += 1;
-    double heatUnitsAdded = (data.maxTemp + data.minTemp) / 2 - prop.baseTemp;
+    double heatUnitsAdded = (data.maxTemp + data.minTemp) / 2 - species().baseTemp;
     heatUnitsAdded = heatUnitsAdded > 0 ? heatUnitsAdded : 0;
     previousHeatUnits = heatUnits;
 
 
     if (heatUnitsAdded + heatUnits > maxHU) // If adding HU will go over the limit,
      {
-        if (prop.isAnnual)
+        if (LifeForm & lfANNUAL)
         {
             dead = true;
         }       
         heatUnitsAdded = 0;
         heatUnits = maxHU;
-        createSeeds(data.date);
+        createSeeds();
         readyForLeafShed = true;
-       /* if (!prop.isAnnual) // test
+       /* if (!species().isAnnual) // test
             seedlist.clear();*/            
     }
 
 
-    if (readyForLeafShed && prop.leafFallPeriod() > 0 && prop.tempCurve.getValue(data.maxTemp) < 0.05)
+    if (readyForLeafShed && prop.leafFallPeriod() > 0 && today.leafShedTemp < 0.05)
     {
         daysLeftForShedding = prop.leafFallPeriod();
         LAIShedPerDay = LAI / daysLeftForShedding;
@@ -154,14 +167,14 @@ void BasePlant::calculate(const WeatherData& data, const double& albedo, const d
     {
         reduceStandingBiomass(data);
         prevLAI = LAI = 0;
-        return;
+        return false;
     }
 
 
     //const double tolerence = 0.00005; // plants less than 1 gram are proclaimed to be dead.
 
-    if (isDormant()) // for decreasing standing biomass.
-        doDormancy();
+    if (isDormantAs<LifeForm>()) // for decreasing standing biomass.
+        doDormancyAs<LifeForm>();
     else
         consecutiveDormantDays = 0;
     
@@ -169,62 +182,85 @@ void BasePlant::calculate(const WeatherData& data, const double& albedo, const d
     if (heatUnits > finalHU)
     {
         heatUnits += heatUnitsAdded;
+        return false;
     }
-    else if (heatUnits < finalHU && !isDead())
-    {
-        doWater(data);
-        doNitrogen();
-        doVernalization(data);
-        doFloralInduction(data);
-        doTempStress(data);
-        findREG();
+    heatUnitsToday = heatUnitsAdded;
+    return heatUnits < finalHU && !isDead();
+}
 
+bool BasePlant::startDay(const DailyForcing& forcing, const SpeciesForcing& today)
+{
+    typedef bool (BasePlant::*Kernel)(const DailyForcing&, const SpeciesForcing&);
+    static const Kernel kernels[lfCOMBINATIONS] = LIFEFORM_KERNELS(BasePlant::startDayAs);
+    return (this->*kernels[species().lifeForm])(forcing, today);
+}
+
+void BasePlant::takeFromSoil(const DailyForcing& forcing)
+{
+    doWater(forcing);
+    doNitrogen();
+}
+
+template <int LifeForm>
+void BasePlant::growAs(const DailyForcing& forcing, const SpeciesForcing& today, const double radiation)
+{
+    const WeatherData& data = forcing.weather;
+    doVernalization(today);
+    doFloralInduction(today);
+    doTempStress(today);
+    findREG();
+
+
+    heatUnits += heatUnitsToday;
+    double deltaHUF = findHUF() - findPreviousHUF();
+    prevLAI = LAI;
+    LAI += deltaHUF * prop.maxLAI() * (1 - exp(5.0f * (prevLAI - prop.maxLAI()))) * sqrt(REG);
+    rootDepth += deltaHUF * prop.maxRootDepth() * sqrt(REG);
+
+    if (LifeForm & lfTREE)
+    {
+        height += deltaHUF * prop.maxYearlyGrowth() * sqrt(REG);
+        if (height > prop.maxHeight())
+            height = prop.maxHeight();
 
-        heatUnits += heatUnitsAdded;
-        double deltaHUF = findHUF() - findPreviousHUF();
-        prevLAI = LAI;
-        LAI += deltaHUF * prop.maxLAI() * (1 - exp(5.0f * (prevLAI - prop.maxLAI()))) * sqrt(REG);
         rootDepth += deltaHUF * prop.maxRootDepth() * sqrt(REG);
+        if (rootDepth > prop.maxRootDepth()) rootDepth = prop.maxRootDepth();
+    }           
+    else
+        height += deltaHUF * prop.maxHeight() * sqrt(REG);    
 
-        if (prop.isTree)
-        {
-            height += deltaHUF * prop.maxYearlyGrowth() * sqrt(REG);
-            if (height > prop.maxHeight())
-                height = prop.maxHeight();
-
-            rootDepth += deltaHUF * prop.maxRootDepth() * sqrt(REG);
-            if (rootDepth > prop.maxRootDepth()) rootDepth = prop.maxRootDepth();
-        }           
-        else
-            height += deltaHUF * prop.maxHeight() * sqrt(REG);    
-
-        ///////////////////////
-        double photoactiveRadiation;
-        if (radiation == -1)
-            double photoactiveRadiation = 0.5 * data.radiation * (1 - exp(-0.65 * LAI));
-        else
-            photoactiveRadiation = radiation;
-     
-        prop.biomassToVPD = 72;
-        double potentialDeltaBiomass = 100 * prop.CO2CurveFactors.getValue(data.CO2); // BE*
-        potentialDeltaBiomass = potentialDeltaBiomass - prop.biomassToVPD * (findVPD((data.maxTemp - data.minTemp) / 2.0f, data.humidity) - 1); // BE'
-        potentialDeltaBiomass = 0.001f * potentialDeltaBiomass * photoactiveRadiation / 10.0f; //result is in kg / m^2  
-
-
-
-
-        potentialDeltaBiomass *= REG;
-        //test
-        potentialDeltaBiomass -= min(0.005, Biomass * 0.002);
-        partitionBiomass(potentialDeltaBiomass);
-
-        currentWaterlogValue -= 0.005;
-        if (currentWaterlogValue < 0)
-            currentWaterlogValue = 0;
-
-        if (maxBiomass < Biomass)
-            maxBiomass = Biomass;
-    }
+    ///////////////////////
+    double photoactiveRadiation;
+    if (radiation == -1)
+        double photoactiveRadiation = 0.5 * data.radiation * (1 - exp(-0.65 * LAI));
+    else
+        photoactiveRadiation = radiation;
+ 
+    double potentialDeltaBiomass = 100 * today.CO2Factor; // BE*
+    potentialDeltaBiomass = potentialDeltaBiomass - species().biomassToVPD * (forcing.VPD - 1); // BE'
+    potentialDeltaBiomass = 0.001f * potentialDeltaBiomass * photoactiveRadiation / 10.0f; //result is in kg / m^2  
+
+
+
+
+    potentialDeltaBiomass *= REG;
+    //test
+    potentialDeltaBiomass -= min(0.005, Biomass * 0.002);
+    partitionBiomassAs<LifeForm>(potentialDeltaBiomass);
+
+    currentWaterlogValue -= 0.005;
+    if (currentWaterlogValue < 0)
+        currentWaterlogValue = 0;
+
+    if (maxBiomass < Biomass)
+        maxBiomass = Biomass;
+}
+
+void BasePlant::grow(const DailyForcing& forcing, const SpeciesForcing& today, const double radiation)
+{
+    typedef void (BasePlant::*Kernel)(const DailyForcing&, const SpeciesForcing&, const double);
+    static const Kernel kernels[lfCOMBINATIONS] = LIFEFORM_KERNELS(BasePlant::growAs);
+    (this->*kernels[species().lifeForm])(forcing, today, radiation);
 }
 
 double BasePlant::getInduction()
@@ -232,15 +268,23 @@ double BasePlant::getInduction()
     return floralInductionUnits;
 }
 
-double BasePlant::getVernalizedRatio()
+template <int LifeForm>
+double BasePlant::getVernalizedRatioAs()
 {
-    if (!prop.needsVernalization)
+    if (!(LifeForm & lfVERNALIZATION))
         return 1;
-    if (!prop.isObligateVernalization || vernalizationUnits > prop.vernalizationThermalUnits)
-        return vernalizationUnits / prop.vernalizationThermalUnits;
+    if (!(LifeForm & lfOBLIGATEVERNALIZATION) || vernalizationUnits > species().vernalizationThermalUnits)
+        return vernalizationUnits / species().vernalizationThermalUnits;
     return 0;
 }
 
+double BasePlant::getVernalizedRatio()
+{
+    typedef double (BasePlant::*Kernel)();
+    static const Kernel kernels[lfCOMBINATIONS] = LIFEFORM_KERNELS(BasePlant::getVernalizedRatioAs);
+    return (this->*kernels[species().lifeForm])();
+}
+
 double BasePlant::getRequiredWater()
 {
     return requiredWater;
@@ -256,18 +300,17 @@ BiomassHolder BasePlant::getBiomassStruct()
     return Biomass;
 }
 
-void BasePlant::doWater(const WeatherData& data)
+void BasePlant::doWater(const DailyForcing& forcing)
 {
     if (soilPatch)
     {
-        double potentialEvaporation = 0.0032 * data.radiation / 2.456 /*MJ/kg*/ * ((data.maxTemp + data.minTemp) / 2 + 17.8) * pow(data.maxTemp - data.minTemp, 0.6); // Hargreaves method.
+        double potentialEvaporation = forcing.potentialEvaporation;
         requiredWater = min(potentialEvaporation, potentialEvaporation * LAI);
         suppliedWater = soilPatch->requestWater(calcRootDepth(), requiredWater);
 
         // next add waterlog damage
-        auto layers = soilPatch->getLayers();
         double depthSum = 0;
-        for (SoilLayer& layer : layers)
+        for (const SoilLayer& layer : soilPatch->viewLayers())
         {
             depthSum += layer.getDepth();
 
@@ -292,34 +335,35 @@ void BasePlant::doNitrogen()
     nitrogen += soilPatch->requestNitrogen(calcRootDepth(), findRequiredNitrogen(), suppliedWater);
 }
 
-void BasePlant::doFloralInduction(const WeatherData& data)
+void BasePlant::doFloralInduction(const SpeciesForcing& species)
 {
     if (heatUnits > maxHU * 0.2 /*floweringHU*/ && heatUnits < endFloweringHU)
-        floralInductionUnits += max(0.0, prop.flowerTempCurve.getValue((data.maxTemp + data.minTemp) / 2.0) * prop.nightLengthCurve.getValue(data.nightLength));
+        floralInductionUnits += max(0.0, species.floralInduction);
 }
 
-void BasePlant::doVernalization(const WeatherData& data)
+void BasePlant::doVernalization(const SpeciesForcing& species)
 {
-    vernalizationUnits += max(0.0, prop.vernalizationCurve.getValue((data.maxTemp + data.minTemp) / 2.0));
+    vernalizationUnits += max(0.0, species.vernalization);
 }
 
-void BasePlant::doTempStress(const WeatherData& data)
+void BasePlant::doTempStress(const SpeciesForcing& species)
 {
-    tempstress = prop.tempCurve.getValue((data.maxTemp + data.minTemp) / 2.0);
+    tempstress = species.tempStress;
     //tempstress = sin(3.1415 / 2.0 * tempstress);
 }
 
-void BasePlant::partitionBiomass(const double dBiomass)
+template <int LifeForm>
+void BasePlant::partitionBiomassAs(const double dBiomass)
 {
     double root, fruit, storage, shoot;
 
     if (heatUnits < floweringHU)
     {
         double ratio = heatUnits / floweringHU;
-        root = prop.baseRatios.roots * (1 - ratio) + prop.fruitingRatios.roots * ratio;
-        fruit = prop.baseRatios.flowerAndfruits * (1 - ratio) + prop.fruitingRatios.flowerAndfruits * ratio;
-        storage = prop.baseRatios.storageOrgan * (1 - ratio) + prop.fruitingRatios.storageOrgan * ratio;
-        shoot = prop.baseRatios.stem * (1 - ratio) + prop.fruitingRatios.stem * ratio;
+        root = species().baseRatios.roots * (1 - ratio) + species().fruitingRatios.roots * ratio;
+        fruit = species().baseRatios.flowerAndfruits * (1 - ratio) + species().fruitingRatios.flowerAndfruits * ratio;
+        storage = species().baseRatios.storageOrgan * (1 - ratio) + species().fruitingRatios.storageOrgan * ratio;
+        shoot = species().baseRatios.stem * (1 - ratio) + species().fruitingRatios.stem * ratio;
         /*
         root = 0.4 - 0.2 * heatUnits / floweringHU;
         fruit = 0 + 0.1 * heatUnits / floweringHU;
@@ -330,10 +374,10 @@ void BasePlant::partitionBiomass(const double dBiomass)
     {
         double ratio = (heatUnits - floweringHU) / (finalHU - floweringHU);
 
-        root = prop.fruitingRatios.roots * (1 - ratio) + prop.finalRatios.roots * ratio;
-        fruit = prop.fruitingRatios.flowerAndfruits * (1 - ratio) + prop.finalRatios.flowerAndfruits * ratio;
-        storage = prop.fruitingRatios.storageOrgan * (1 - ratio) + prop.finalRatios.storageOrgan * ratio;
-        shoot = prop.fruitingRatios.stem * (1 - ratio) + prop.finalRatios.stem * ratio;
+        root = species().fruitingRatios.roots * (1 - ratio) + species().finalRatios.roots * ratio;
+        fruit = species().fruitingRatios.flowerAndfruits * (1 - ratio) + species().finalRatios.flowerAndfruits * ratio;
+        storage = species().fruitingRatios.storageOrgan * (1 - ratio) + species().finalRatios.storageOrgan * ratio;
+        shoot = species().fruitingRatios.stem * (1 - ratio) + species().finalRatios.stem * ratio;
 
 
         /*root = 0.2 - 0.1 * ratio;
@@ -343,7 +387,7 @@ void BasePlant::partitionBiomass(const double dBiomass)
 
         fruit = 0.1 + 0.4 * ratio;*/
 
-        if (!canFlower()) // if it's not able to flower, route all of the biomass into the other parts of the plant.
+        if (!canFlowerAs<LifeForm>()) // if it's not able to flower, route all of the biomass into the other parts of the plant.
         {
             root += fruit / 3;
             storage += fruit / 3;
@@ -351,16 +395,16 @@ void BasePlant::partitionBiomass(const double dBiomass)
             fruit = 0;
         }
 
-        fruit *= getVernalizedRatio(); // Reduce the efficiency of the flowering depending on its vernalization status.
+        fruit *= getVernalizedRatioAs<LifeForm>(); // Reduce the efficiency of the flowering depending on its vernalization status.
     }
     else
     {
-        root = prop.finalRatios.roots;
-        fruit = prop.finalRatios.flowerAndfruits;
-        storage = prop.finalRatios.storageOrgan;
-        shoot = prop.finalRatios.stem;
+        root = species().finalRatios.roots;
+        fruit = species().finalRatios.flowerAndfruits;
+        storage = species().finalRatios.storageOrgan;
+        shoot = species().finalRatios.stem;
 
-        if (!canFlower())
+        if (!canFlowerAs<LifeForm>())
         {
             root += fruit / 3;
             storage += fruit / 3;
@@ -368,7 +412,7 @@ void BasePlant::partitionBiomass(const double dBiomass)
             fruit = 0;
         }
 
-        fruit *= getVernalizedRatio();
+        fruit *= getVernalizedRatioAs<LifeForm>();
     }
 
     Biomass.roots += dBiomass * root;
@@ -385,41 +429,37 @@ void BasePlant::partitionBiomass(const double dBiomass)
     if (Biomass.flowerAndfruits < 0)
         Biomass.flowerAndfruits = 0;
 
-    /*if (prop.isAnnual)
+    /*if (species().isAnnual)
     {
         Biomass.flowerAndfruits += Biomass.storageOrgan;
         Biomass.storageOrgan = 0;
     }    */
 }
 
-void BasePlant::doDormancy()
+void BasePlant::partitionBiomass(const double dBiomass)
+{
+    typedef void (BasePlant::*Kernel)(const double);
+    static const Kernel kernels[lfCOMBINATIONS] = LIFEFORM_KERNELS(BasePlant::partitionBiomassAs);
+    (this->*kernels[species().lifeForm])(dBiomass);
+}
+
+template <int LifeForm>
+void BasePlant::doDormancyAs()
 {
-    const double tolerence = 0.00005;
     consecutiveDormantDays++;
     floralInductionUnits = 0;
 
-    if (true)//!prop.isTree) // current dummy function.
+    if (true)//!species().isTree) // current dummy function.
     {
-        height *= prop.dormantHeightDecrease;
-        rootDepth *= prop.dormantRootDecrease;
+        height *= species().dormantHeightDecrease;
+        rootDepth *= species().dormantRootDecrease;
 
-        if (Biomass < tolerence)
+        if (!decayDormantBiomass(Biomass))
             dead = true;
-        else if (Biomass - Biomass.storageOrgan > tolerence) // there are other parts of the plant left
-        {
-            // consume said parts
-            Biomass.flowerAndfruits *= prop.dormantBiomassDecrease.flowerAndfruits;
-            Biomass.roots *= prop.dormantBiomassDecrease.roots;
-            Biomass.stem *= prop.dormantBiomassDecrease.stem;
-        }
-        else // otherwise consume the storage organ
-        {
-            Biomass.storageOrgan *= prop.dormantBiomassDecrease.storageOrgan;
-        }
     }
 
 
-    if (!prop.isAnnual && consecutiveDormantDays > 30)
+    if (!(LifeForm & lfANNUAL) && consecutiveDormantDays > 30)
     {
         heatUnits = 0;
         currentWaterlogValue *= 0.5;
@@ -427,6 +467,93 @@ void BasePlant::doDormancy()
     }
 }
 
+bool BasePlant::decayDormantBiomass(BiomassHolder& biomass)
+{
+    const double tolerence = 0.00005;
+    if (biomass < tolerence)
+        return false;
+    else if (biomass - biomass.storageOrgan > tolerence) // there are other parts of the plant left
+    {
+        // consume said parts
+        biomass.flowerAndfruits *= species().dormantBiomassDecrease.flowerAndfruits;
+        biomass.roots *= species().dormantBiomassDecrease.roots;
+        biomass.stem *= species().dormantBiomassDecrease.stem;
+    }
+    else // otherwise consume the storage organ
+    {
+        biomass.storageOrgan *= species().dormantBiomassDecrease.storageOrgan;
+    }
+    return true;
+}
+
+int BasePlant::findSleepDays()
+{
+    // startDay() returns early every day until doDormancy() resets the heat units after 30 days.
+    if (dead || (species().lifeForm & lfANNUAL) || heatUnits != maxHU || heatUnits <= finalHU || consecutiveDormantDays < 1)
+        return 0;
+    // Nothing the weather can start makes a difference: no leaves to shed, no fruit to make seeds from.
+    if (LAI != 0 || (daysLeftForShedding > 0 && LAIShedPerDay != 0) || Biomass.flowerAndfruits >= prop.averageFruitWeight() || !seedlist.empty())
+        return 0;
+
+    const int days = 30 - consecutiveDormantDays;
+    BiomassHolder biomass = Biomass;
+    for (int counter = 0; counter < days; counter++)
+        if (!decayDormantBiomass(biomass))
+            return 0; // It dies on one of them, which the soil has to see on the day.
+    return days;
+}
+
+void BasePlant::passDormantDay(const char& dayType)
+{
+    // What startDay() and doDormancy() do on such a day. Heat units stay at maxHU and createSeeds() finds no fruit.
+    age += 1;
+    previousHeatUnits = heatUnits;
+    if (dayType & ddWARM)
+        readyForLeafShed = true;
+
+    if (readyForLeafShed && prop.leafFallPeriod() > 0 && (dayType & ddLEAFSHED))
+    {
+        daysLeftForShedding = prop.leafFallPeriod();
+        LAIShedPerDay = LAI / daysLeftForShedding;
+        readyForLeafShed = false;
+    }
+    if (daysLeftForShedding > 0)
+    {
+        prevLAI = LAI;
+        LAI -= LAIShedPerDay;
+        daysLeftForShedding--;
+        if (daysLeftForShedding == 0)
+            LAI = 0;
+    }
+
+    consecutiveDormantDays++;
+    floralInductionUnits = 0;
+    height *= species().dormantHeightDecrease;
+    rootDepth *= species().dormantRootDecrease;
+    decayDormantBiomass(Biomass);
+}
+
+char BasePlant::findDormantDay(const SpeciesProperties& species, const WeatherData& data, const SpeciesForcing& today)
+{
+    // Same tests as startDay(), for a plant sitting at maxHU.
+    const double maxHU = species.growthStages.at(10);
+    double heatUnitsAdded = (data.maxTemp + data.minTemp) / 2 - species.baseTemp;
+    heatUnitsAdded = heatUnitsAdded > 0 ? heatUnitsAdded : 0;
+    char dayType = 0;
+    if (heatUnitsAdded + maxHU > maxHU)
+        dayType |= ddWARM;
+    if (today.leafShedTemp < 0.05)
+        dayType |= ddLEAFSHED;
+    return dayType;
+}
+
+void BasePlant::doDormancy()
+{
+    typedef void (BasePlant::*Kernel)();
+    static const Kernel kernels[lfCOMBINATIONS] = LIFEFORM_KERNELS(BasePlant::doDormancyAs);
+    (this->*kernels[species().lifeForm])();
+}
+
 double BasePlant::getWaterStressFactor()
 {
     if (requiredWater != 0)
@@ -453,22 +580,22 @@ double BasePlant::getNitrogenStressFactor()
 
 double BasePlant::findHUI()
 {
-    return heatUnits / prop.growthStages.find(9)->second; // rbegin = back
+    return heatUnits / species().growthStages.at(9); // rbegin = back
 }
 
 double BasePlant::findPreviousHUI()
 {
-    return previousHeatUnits / prop.growthStages.find(9)->second; // rbegin = back
+    return previousHeatUnits / species().growthStages.at(9); // rbegin = back
 }
 
 double BasePlant::findHUF()
 {
-    return prop.HeatUnitFactorNums.getValue(findHUI());
+    return species().HeatUnitFactorNums.getValue(findHUI());
 }
 
 double BasePlant::findPreviousHUF()
 {
-    return prop.HeatUnitFactorNums.getValue(findPreviousHUI());
+    return species().HeatUnitFactorNums.getValue(findPreviousHUI());
 }
 
 double BasePlant::findVPD(const double& averageTemp, const double& humidity)
@@ -488,18 +615,26 @@ double BasePlant::calcRootDepth()
     return rootDepth;
 }
 
-bool BasePlant::canFlower()
+template <int LifeForm>
+bool BasePlant::canFlowerAs()
 {
-    if (prop.isTree && getAge() < prop.yearsUntilMaturity()) // if is a tree, is under mature age.
+    if ((LifeForm & lfTREE) && getAge() < prop.yearsUntilMaturity()) // if is a tree, is under mature age.
         return false;
-    if (floralInductionUnits > prop.floralInductionUnitsRequired)
-        if (!prop.needsVernalization  // doesn't need vernalization
-            || !prop.isObligateVernalization  // doesn't need to be fully vernalized to flower
-            || vernalizationUnits > prop.vernalizationThermalUnits) // is sufficiently vernalized
+    if (floralInductionUnits > species().floralInductionUnitsRequired)
+        if (!(LifeForm & lfVERNALIZATION)  // doesn't need vernalization
+            || !(LifeForm & lfOBLIGATEVERNALIZATION)  // doesn't need to be fully vernalized to flower
+            || vernalizationUnits > species().vernalizationThermalUnits) // is sufficiently vernalized
             return true;
     return false;
 }
 
+bool BasePlant::canFlower()
+{
+    typedef bool (BasePlant::*Kernel)();
+    static const Kernel kernels[lfCOMBINATIONS] = LIFEFORM_KERNELS(BasePlant::canFlowerAs);
+    return (this->*kernels[species().lifeForm])();
+}
+
 double BasePlant::findPsychometricConstant(const double& temperature)
 {
     return temperature > 0 ? 0.000666f : 0.000594; // if temp is larger than 0, return left, else right
@@ -525,7 +660,7 @@ double BasePlant::findOptimalNitrogenConcentration()
     // Interpolates between start and final, with it reaching final values before flowering HU
     double ratio = min(1.0, heatUnits / floweringHU);
     
-    double temp =  (1 - ratio) * prop.startingNitrogenConcentration + ratio * prop.finalNitrogenConcentration;
+    double temp =  (1 - ratio) * species().startingNitrogenConcentration + ratio * species().finalNitrogenConcentration;
     return temp;
 }
 
@@ -545,17 +680,25 @@ double BasePlant::getBiomass()
     return Biomass;
 }
 
-double BasePlant::getLAI()
+template <int LifeForm>
+double BasePlant::getLAIAs()
 {
     double ageMod = 1;
     double deadMod = 1;
-    if (prop.isTree)
+    if (LifeForm & lfTREE)
         ageMod = min(1.0, getAge() / (double)prop.yearsUntilMaturity());
     if (isDead())
         deadMod = 0;
     return LAI * ageMod * deadMod;
 }
 
+double BasePlant::getLAI()
+{
+    typedef double (BasePlant::*Kernel)();
+    static const Kernel kernels[lfCOMBINATIONS] = LIFEFORM_KERNELS(BasePlant::getLAIAs);
+    return (this->*kernels[species().lifeForm])();
+}
+
 double BasePlant::getHU()
 {
     return heatUnits;
@@ -578,7 +721,7 @@ double BasePlant::findFallenLeaves()
 
 std::string BasePlant::getName()
 {
-    return prop.name;
+    return species().name;
 }
 
 bool BasePlant::isDead()
@@ -586,9 +729,10 @@ bool BasePlant::isDead()
     return dead;
 }
 
-bool BasePlant::isDormant()
+template <int LifeForm>
+bool BasePlant::isDormantAs()
 {
-    if (!prop.isAnnual && heatUnits >= maxHU)
+    if (!(LifeForm & lfANNUAL) && heatUnits >= maxHU)
         return true;
     if (tempstress < 0.001)
         return true;
@@ -596,7 +740,14 @@ bool BasePlant::isDormant()
     return false;
 }
 
-void BasePlant::createSeeds(const Month& date)
+bool BasePlant::isDormant()
+{
+    typedef bool (BasePlant::*Kernel)();
+    static const Kernel kernels[lfCOMBINATIONS] = LIFEFORM_KERNELS(BasePlant::isDormantAs);
+    return (this->*kernels[species().lifeForm])();
+}
+
+void BasePlant::createSeeds()
 {
     if (Biomass.flowerAndfruits < prop.averageFruitWeight())
         return;
@@ -615,7 +766,7 @@ void BasePlant::createSeeds(const Month& date)
     double sum = 0;
     for (int counter = 0; counter < numSeeds; counter++)
     {
-        double added = random(0.01, 1);
+        double added = rng.uniform(age, counter, 0.01, 1);
         seedWeights[counter] = added;
         sum += added;
     }
@@ -630,10 +781,7 @@ void BasePlant::createSeeds(const Month& date)
     for (int counter = 0; counter < numSeeds; counter++)
     {
         double fruitWeight = prop.averageFruitWeight() + extraWeight * seedWeights[counter];
-        double seedWeight = fruitWeight * prop.seedRatio();
-        fruitWeight -= seedWeight;
-
-        seedlist.push_back(Seed(prop, vp, date, prop.dormancy, seedWeight, fruitWeight));
+        seedlist.push_back(fruitWeight * prop.seedRatio());
     }
 
     Biomass.flowerAndfruits = 0;
@@ -667,11 +815,11 @@ int BasePlant::getAge()
 
 int BasePlant::geticon()
 {
-    if (isDead() || getHU() < prop.growthStages[10] * .1)
+    if (isDead() || getHU() < species().growthStages.at(10) * .1)
         return 0;
-    else if (getHU() < prop.growthStages[6])
+    else if (getHU() < species().growthStages.at(6))
         return vp.icon_sprout;
-    else if (getHU() < prop.growthStages[7])
+    else if (getHU() < species().growthStages.at(7))
         return vp.icon_vegetative;
     else
         return vp.icon_mature;
@@ -5,7 +5,9 @@
 #include "curves.h"
 #include "plantproperties.h"
 #include "seed.h"
-#include <random>
+#include "forcing.h"
+#include "counterRng.h"
+#include "canopy.h"
 
 
 namespace ALMANAC
@@ -13,19 +15,26 @@ namespace ALMANAC
     class SoilCell;
     class SoilGrid;
 
+    // What a day does to a plant sleeping through its dormancy. See BasePlant::findDormantDay().
+    enum DORMANTDAY { ddWARM = 1, ddLEAFSHED = 2 };
+
     class BasePlant
     {
         friend class SoilGrid;
+        friend class Canopy;
+        friend class PlantBatch;
     public:
         BasePlant(SoilCell* soil = 0);
-        BasePlant(Seed seed, SoilCell* soil = 0);
+        BasePlant(const SeedCohort& seeds, SoilCell* soil = 0); // Grows from one seed of average weight.
         BasePlant(PlantProperties plantprop, PlantVisualProperties visualprop = PlantVisualProperties(), SoilCell* soil = 0);
         
 
         std::string getName();
         int geticon();
         void calculate(const WeatherData& data, const double& albedo, const double radiation = -1); // plug in today's weather :v. CO2 is in ppm
+        void calculate(const DailyForcing& forcing, const double& albedo, const double radiation = -1); // Same, with the day's shared values already worked out.
         void findREG(); // probably has params
+        // The getters and state below are current every day, also on the days SoilGrid runs only passDormantDay().
         double getHU(); // heat units
         double findHUI(); // heat unit indx, basically % grown.
         double calcHeight();
@@ -53,19 +62,26 @@ namespace ALMANAC
         bool isDead();
         bool isDormant();
 
-        void createSeeds(const Month& date);
+        void createSeeds(); // Fills seedlist.
 
-        std::vector<Seed> seedlist;
+        std::vector<double> seedlist; // kg, the weight of each seed made by createSeeds(), until the soil collects them.
 
         double deadBiomass;
         double removedNitrogen;
 
         PlantVisualProperties vp;
+
+        static SCurve getSCurve(const bool dayNeutral, const bool longDayPlant, double minInduction, const double& optimalInductionNightLength);
+        static double findVPD(const double& averageTemp, const double& humidity);
+        // Boils the day down to the DORMANTDAY flags, the only part of it a sleeping plant of the species sees.
+        static char findDormantDay(const SpeciesProperties& species, const WeatherData& data, const SpeciesForcing& today);
     private:
-        mt19937 rng;
-        double random(double min = 0, double max = 1);
+        CanopyProfile canopyProfile;
+        double canopyLAI; // getLAI() as of the last Canopy::shareLight().
+        CounterRNG rng; // Draws are keyed by (age, draw), so a plant's numbers don't depend on what else has drawn. Default key until SoilGrid::addPlant gives it its own stream.
 
         PlantProperties prop;
+        const SpeciesProperties& species() const { return prop.species(); }
         
 
         bool dead;
@@ -80,7 +96,7 @@ namespace ALMANAC
         int consecutiveDormantDays;
 
         int getAge(); // in years
-        int age; // incremented each time calculate() is called. Divide by 360 to get age in years.
+        int age; // incremented each time calculate() or passDormantDay() is called. Divide by 360 to get age in years.
 
         double height; // mm
         double rootDepth; // mm
@@ -93,8 +109,6 @@ namespace ALMANAC
         double floralInductionUnits;
         double vernalizationUnits;
 
-        static SCurve getSCurve(const bool dayNeutral, const bool longDayPlant, double minInduction, const double& optimalInductionNightLength);
-
         BiomassHolder Biomass;  // kg        
 
         double nitrogen; // kg/ha
@@ -106,7 +120,6 @@ namespace ALMANAC
         double findHUF();
         double findPreviousHUF();
         double findPreviousHUI();
-        double findVPD(const double& averageTemp, const double& humidity);
         double findPsychometricConstant(const double& temperature = 2.0f); // AKA 'gamma'
         double findSlopeOfSaturatedVaporCurve(const double& temperature);
         double findNetRadiation(const double& radiation, const double& albedo); //aka h(0)
@@ -125,15 +138,45 @@ namespace ALMANAC
         double finalHU;
         double maxHU;
 
-        void doWater(const WeatherData& data);
+        // calculate() in three parts. Only takeFromSoil() touches the soil, so the other two can run
+        // for many plants at once, as long as each cell's plants take from the soil in order.
+        SpeciesForcing getSpeciesForcing(const DailyForcing& forcing);
+        bool startDay(const DailyForcing& forcing, const SpeciesForcing& today); // Ages the plant. Returns true if it grows today.
+        void takeFromSoil(const DailyForcing& forcing);
+        void grow(const DailyForcing& forcing, const SpeciesForcing& today, const double radiation);
+        double heatUnitsToday; // Set by startDay() for grow().
+
+        // The daily code for each lifeForm, with the species flags as constants so each one has no branches on them.
+        // calculate(), startDay(), grow() and the rest below pick the one for the plant's species.
+        template <int LifeForm> void calculateAs(const DailyForcing& forcing, const double radiation);
+        template <int LifeForm> bool startDayAs(const DailyForcing& forcing, const SpeciesForcing& today);
+        template <int LifeForm> void growAs(const DailyForcing& forcing, const SpeciesForcing& today, const double radiation);
+        template <int LifeForm> void partitionBiomassAs(const double dBiomass);
+        template <int LifeForm> void doDormancyAs();
+        template <int LifeForm> bool isDormantAs();
+        template <int LifeForm> bool canFlowerAs();
+        template <int LifeForm> double getVernalizedRatioAs();
+        template <int LifeForm> double getLAIAs();
+
+        void doWater(const DailyForcing& forcing);
         void doNitrogen();
-        void doFloralInduction(const WeatherData& data);
-        void doVernalization(const WeatherData& data);
+        void doFloralInduction(const SpeciesForcing& species);
+        void doVernalization(const SpeciesForcing& species);
         void partitionBiomass(const double dBiomass);
-        void doTempStress(const WeatherData& wd);
+        void doTempStress(const SpeciesForcing& species);
         void doDormancy();
 
         void reduceStandingBiomass(const WeatherData& data); // = die off, for annual plants.
+        bool decayDormantBiomass(BiomassHolder& biomass); // One day of it for doDormancy(). False, and no decay, if too little is left.
+
+        // A perennial waiting out its heat unit reset with no leaves and no fruit left only ages and decays, and the
+        // weather only decides when it would start shedding leaves it doesn't have. SoilGrid runs just that on those
+        // days, from the day's DORMANTDAY flags, instead of the whole calculate(). No day is skipped, so the plant is up
+        // to date every day. The wait only ends when the heat units reset, at most 30 days in, so that is when it wakes.
+        // Cold (tempstress) dormancy isn't cut short: grow() still takes water and nitrogen and respires on those days.
+        int findSleepDays(); // How many of the coming days can be cut short like that, 0 if none.
+        void passDormantDay(const char& dayType); // startDay() for one of those days.
+        unsigned int sleepEnd; // The SoilGrid day the plant goes back to calculate().
         double tempstress;
     };
 }
\ No newline at end of file
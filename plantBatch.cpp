@@ -0,0 +1,223 @@
+#include "plantBatch.h"
+#include "plant.h"
+#include <cmath>
+#include <algorithm>
+
+using namespace ALMANAC;
+
+void PlantBatch::add(BasePlant& plant, const double& light)
+{
+    plants.push_back(&plant);
+    radiation.push_back(light);
+    heatUnits.push_back(plant.heatUnits);
+    previousHeatUnits.push_back(plant.previousHeatUnits);
+    heatUnitsToday.push_back(plant.heatUnitsToday);
+    LAI.push_back(plant.LAI);
+    height.push_back(plant.height);
+    rootDepth.push_back(plant.rootDepth);
+    maxLAI.push_back(plant.prop.maxLAI());
+    maxRootDepth.push_back(plant.prop.maxRootDepth());
+    maxHeight.push_back(plant.prop.maxHeight());
+    maxYearlyGrowth.push_back(plant.prop.maxYearlyGrowth());
+    waterTolerence.push_back(plant.prop.waterTolerence());
+    roots.push_back(plant.Biomass.roots);
+    stem.push_back(plant.Biomass.stem);
+    storageOrgan.push_back(plant.Biomass.storageOrgan);
+    flowerAndfruits.push_back(plant.Biomass.flowerAndfruits);
+    nitrogen.push_back(plant.nitrogen);
+    requiredWater.push_back(plant.requiredWater);
+    suppliedWater.push_back(plant.suppliedWater);
+    waterlog.push_back(plant.currentWaterlogValue);
+    floralInduction.push_back(plant.floralInductionUnits);
+    vernalization.push_back(plant.vernalizationUnits);
+    REG.push_back(0);
+    immature.push_back((plant.species().lifeForm & lfTREE) && plant.getAge() < plant.prop.yearsUntilMaturity());
+}
+
+int PlantBatch::size() const
+{
+    return plants.size();
+}
+
+void PlantBatch::grow(const DailyForcing& forcing)
+{
+    if (plants.empty())
+        return;
+
+    // One species per batch, so its kernel is picked once for all of its plants.
+    typedef void (PlantBatch::*Kernel)(const DailyForcing&);
+    static const Kernel kernels[lfCOMBINATIONS] = LIFEFORM_KERNELS(PlantBatch::growAs);
+    (this->*kernels[plants[0]->species().lifeForm])(forcing);
+}
+
+template <int LifeForm>
+void PlantBatch::growAs(const DailyForcing& forcing)
+{
+    const int count = plants.size();
+    const SpeciesProperties& species = plants[0]->species();
+    const SpeciesForcing today = plants[0]->getSpeciesForcing(forcing);
+    const double floweringHU = species.growthStages.at(6);
+    const double endFloweringHU = species.growthStages.at(7);
+    const double finalHU = species.growthStages.at(9);
+    const double maxHU = species.growthStages.at(10);
+    const SCurve& HUF = species.HeatUnitFactorNums;
+
+    // Vernalization, floral induction and REG. Same as doVernalization() through findREG().
+    const double vernalizationAdded = std::max(0.0, today.vernalization);
+    const double inductionAdded = std::max(0.0, today.floralInduction);
+    const double tempstress = today.tempStress;
+    for (int i = 0; i < count; i++)
+    {
+        vernalization[i] += vernalizationAdded;
+        if (heatUnits[i] > maxHU * 0.2 && heatUnits[i] < endFloweringHU)
+            floralInduction[i] += inductionAdded;
+
+        double waterStress = requiredWater[i] != 0 ? std::min(suppliedWater[i] / requiredWater[i], 1.0) : 1.0;
+        double waterlogStress = pow(std::max(0.0, 1 - waterlog[i] / waterTolerence[i]), 1 / 3.0);
+
+        double biomass = flowerAndfruits[i] + roots[i] + stem[i] + storageOrgan[i];
+        double ratio = std::min(1.0, heatUnits[i] / floweringHU);
+        double optimalNitrogen = (1 - ratio) * species.startingNitrogenConcentration + ratio * species.finalNitrogenConcentration;
+        double nitrogenStress = 200.0 * nitrogen[i] / (optimalNitrogen * biomass) - 100.0;
+        nitrogenStress = std::max(nitrogenStress, 0.0);
+        nitrogenStress = nitrogenStress / (nitrogenStress + exp(3.52 - 0.026 * nitrogenStress));
+
+        double reg = 1;
+        reg = std::min(reg, waterStress);
+        reg = std::min(reg, waterlogStress);
+        reg = std::min(reg, nitrogenStress);
+        reg = std::min(reg, std::max(tempstress, 0.0));
+        REG[i] = reg;
+    }
+
+    // Heat units, LAI, height and root depth. The prevLAI written back is the LAI before this.
+    std::vector<double> prevLAI(LAI);
+    for (int i = 0; i < count; i++)
+    {
+        heatUnits[i] += heatUnitsToday[i];
+        double HUI = heatUnits[i] / finalHU;
+        double previousHUI = previousHeatUnits[i] / finalHU;
+        double deltaHUF = (HUF.up + HUF.vert / (1 + exp(-HUF.scale * (HUI - HUF.horiz))))
+            - (HUF.up + HUF.vert / (1 + exp(-HUF.scale * (previousHUI - HUF.horiz))));
+        LAI[i] += deltaHUF * maxLAI[i] * (1 - exp(5.0f * (prevLAI[i] - maxLAI[i]))) * sqrt(REG[i]);
+        rootDepth[i] += deltaHUF * maxRootDepth[i] * sqrt(REG[i]);
+        if (LifeForm & lfTREE)
+        {
+            height[i] += deltaHUF * maxYearlyGrowth[i] * sqrt(REG[i]);
+            if (height[i] > maxHeight[i])
+                height[i] = maxHeight[i];
+            rootDepth[i] += deltaHUF * maxRootDepth[i] * sqrt(REG[i]);
+            if (rootDepth[i] > maxRootDepth[i])
+                rootDepth[i] = maxRootDepth[i];
+        }
+        else
+            height[i] += deltaHUF * maxHeight[i] * sqrt(REG[i]);
+    }
+
+    // Biomass, same as the end of grow() and partitionBiomass().
+    const double efficiency = 100 * today.CO2Factor - species.biomassToVPD * (forcing.VPD - 1); // BE'
+    for (int i = 0; i < count; i++)
+    {
+        double biomass = flowerAndfruits[i] + roots[i] + stem[i] + storageOrgan[i];
+        double dBiomass = 0.001f * efficiency * radiation[i] / 10.0f;
+        dBiomass *= REG[i];
+        dBiomass -= std::min(0.005, biomass * 0.002);
+
+        bool canFlower = !immature[i] && floralInduction[i] > species.floralInductionUnitsRequired
+            && (!(LifeForm & lfVERNALIZATION) || !(LifeForm & lfOBLIGATEVERNALIZATION) || vernalization[i] > species.vernalizationThermalUnits);
+        double vernalizedRatio = 1;
+        if (LifeForm & lfVERNALIZATION)
+            vernalizedRatio = !(LifeForm & lfOBLIGATEVERNALIZATION) || vernalization[i] > species.vernalizationThermalUnits ? vernalization[i] / species.vernalizationThermalUnits : 0;
+
+        double root, fruit, storage, shoot;
+        if (heatUnits[i] < floweringHU)
+        {
+            double ratio = heatUnits[i] / floweringHU;
+            root = species.baseRatios.roots * (1 - ratio) + species.fruitingRatios.roots * ratio;
+            fruit = species.baseRatios.flowerAndfruits * (1 - ratio) + species.fruitingRatios.flowerAndfruits * ratio;
+            storage = species.baseRatios.storageOrgan * (1 - ratio) + species.fruitingRatios.storageOrgan * ratio;
+            shoot = species.baseRatios.stem * (1 - ratio) + species.fruitingRatios.stem * ratio;
+        }
+        else
+        {
+            if (heatUnits[i] < finalHU)
+            {
+                double ratio = (heatUnits[i] - floweringHU) / (finalHU - floweringHU);
+                root = species.fruitingRatios.roots * (1 - ratio) + species.finalRatios.roots * ratio;
+                fruit = species.fruitingRatios.flowerAndfruits * (1 - ratio) + species.finalRatios.flowerAndfruits * ratio;
+                storage = species.fruitingRatios.storageOrgan * (1 - ratio) + species.finalRatios.storageOrgan * ratio;
+                shoot = species.fruitingRatios.stem * (1 - ratio) + species.finalRatios.stem * ratio;
+            }
+            else
+            {
+                root = species.finalRatios.roots;
+                fruit = species.finalRatios.flowerAndfruits;
+                storage = species.finalRatios.storageOrgan;
+                shoot = species.finalRatios.stem;
+            }
+            if (!canFlower)
+            {
+                root += fruit / 3;
+                storage += fruit / 3;
+                shoot += fruit / 3;
+                fruit = 0;
+            }
+            fruit *= vernalizedRatio;
+        }
+
+        roots[i] = std::max(roots[i] + dBiomass * root, 0.0);
+        stem[i] = std::max(stem[i] + dBiomass * shoot, 0.0);
+        storageOrgan[i] = std::max(storageOrgan[i] + dBiomass * storage, 0.0);
+        flowerAndfruits[i] = std::max(flowerAndfruits[i] + dBiomass * fruit, 0.0);
+
+        waterlog[i] = std::max(waterlog[i] - 0.005, 0.0);
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        BasePlant& plant = *plants[i];
+        plant.heatUnits = heatUnits[i];
+        plant.prevLAI = prevLAI[i];
+        plant.LAI = LAI[i];
+        plant.height = height[i];
+        plant.rootDepth = rootDepth[i];
+        plant.Biomass = BiomassHolder(stem[i], roots[i], storageOrgan[i], flowerAndfruits[i]);
+        plant.currentWaterlogValue = waterlog[i];
+        plant.floralInductionUnits = floralInduction[i];
+        plant.vernalizationUnits = vernalization[i];
+        plant.tempstress = tempstress;
+        plant.REG = REG[i];
+        if (plant.maxBiomass < plant.Biomass)
+            plant.maxBiomass = plant.Biomass;
+    }
+    clear();
+}
+
+void PlantBatch::clear()
+{
+    plants.clear();
+    radiation.clear();
+    heatUnits.clear();
+    previousHeatUnits.clear();
+    heatUnitsToday.clear();
+    LAI.clear();
+    height.clear();
+    rootDepth.clear();
+    maxLAI.clear();
+    maxRootDepth.clear();
+    maxHeight.clear();
+    maxYearlyGrowth.clear();
+    waterTolerence.clear();
+    roots.clear();
+    stem.clear();
+    storageOrgan.clear();
+    flowerAndfruits.clear();
+    nitrogen.clear();
+    requiredWater.clear();
+    suppliedWater.clear();
+    waterlog.clear();
+    floralInduction.clear();
+    vernalization.clear();
+    REG.clear();
+    immature.clear();
+}
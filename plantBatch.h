@@ -0,0 +1,36 @@
+#pragma once
+#include <vector>
+
+namespace ALMANAC
+{
+    class BasePlant;
+    struct DailyForcing;
+
+    /**
+    Grows many plants of one species at once. add() copies the state BasePlant::grow() works on into one array per
+    field, grow() runs each step of it as a plain loop over those arrays, then writes the results back. The loops
+    have no per-plant calls and few branches, so the compiler can vectorize them, exp(), pow() and sqrt() included.
+    Same arithmetic as BasePlant::grow(), in the same order.
+    **/
+    class PlantBatch
+    {
+    public:
+        void add(BasePlant& plant, const double& radiation); // The plant must have had startDay() and takeFromSoil() today.
+        int size() const;
+        void grow(const DailyForcing& forcing); // BasePlant::grow() for every plant added. Empties the batch.
+
+    private:
+        template <int LifeForm> void growAs(const DailyForcing& forcing); // grow() with the species flags as constants.
+        void clear();
+
+        std::vector<BasePlant*> plants;
+        // One entry per plant
+        std::vector<double> radiation, heatUnits, previousHeatUnits, heatUnitsToday;
+        std::vector<double> LAI, height, rootDepth;
+        std::vector<double> maxLAI, maxRootDepth, maxHeight, maxYearlyGrowth, waterTolerence; // Genes
+        std::vector<double> roots, stem, storageOrgan, flowerAndfruits;
+        std::vector<double> nitrogen, requiredWater, suppliedWater, waterlog;
+        std::vector<double> floralInduction, vernalization, REG;
+        std::vector<char> immature; // Trees younger than their maturity age can't flower.
+    };
+}
@@ -1,12 +1,16 @@
 #include "plantDictionary.h"
+#include "plant.h"
+#include "speciesCatalog.h"
 #include <fstream>
 #include <iostream>
+#include <iterator>
 
 
 using namespace ALMANAC;
 using namespace std;
 
 PlantDictionary PD;
+const char* const catalogFile = "Content/species.catalog";
 
 PlantDictionary::PlantDictionary()
 {
@@ -15,21 +19,54 @@ PlantDictionary::PlantDictionary()
 
 void PlantDictionary::init()
 {
-    loadProperties();
-    loadVisualProperties();
+    // The JSON is only read to check the catalog is still up to date, not parsed, unless it isn't.
+    const string properties = slurp("Content/plantproperties.json");
+    const string visuals = slurp("Content/visualproperties.json");
+    const unsigned int sourceHash = hashCatalogSource(visuals, hashCatalogSource(properties));
+    if (!loadCatalog(catalogFile, sourceHash))
+    {
+        bool valid = loadProperties(properties);
+        valid = loadVisualProperties(visuals) && valid;
+        if (valid) // A catalog is only made from JSON that loaded cleanly.
+            compileCatalog(catalogFile, sourceHash);
+    }
     cout << "input done\n";
 }
 
+bool PlantDictionary::loadCatalog(const string& filename, const unsigned int& sourceHash)
+{
+    std::vector<MasterPlantProperties> species;
+    if (!readSpeciesCatalog(filename, sourceHash, species, visuallist))
+        return false;
+    for (MasterPlantProperties& pp : species)
+    {
+        pp.lifeForm = pp.findLifeForm();
+        pp.speciesID = speciesNames.intern(pp.name);
+        if (pp.speciesID < (int)propertieslist.size())
+            propertieslist[pp.speciesID] = pp;
+        else
+            propertieslist.push_back(pp);
+    }
+    return true;
+}
 
-void PlantDictionary::loadVisualProperties()
+bool PlantDictionary::compileCatalog(const string& filename, const unsigned int& sourceHash)
+{
+    if (writeSpeciesCatalog(filename, sourceHash, propertieslist, visuallist))
+        return true;
+    cout << "Could not write the species catalog " << filename << "\n";
+    return false;
+}
+
+bool PlantDictionary::loadVisualProperties(const string& json)
 {
     Json::Reader reader;
     Json::Value root;
-    bool success = reader.parse(slurp("Content/visualproperties.json"), root);
+    bool success = reader.parse(json, root);
     if (!success)
     {
         cout << "Did not succeed: " << reader.getFormattedErrorMessages() << "\n";
-        return;
+        return false;
     }
 
     int counter = 0;
@@ -62,10 +99,11 @@ void PlantDictionary::loadVisualProperties()
         visuallist[vp.ID] = vp;
         counter++;
     }
+    return true;
 }
 
-// Assigns a range of data from element to var.
-void assignPairs(pair<int, int>& var, Json::Value element)
+// Assigns a range of data from element to var. False if there is none.
+bool assignPairs(pair<int, int>& var, Json::Value element)
 {
     if (element.size() == 1)
     {
@@ -79,9 +117,11 @@ void assignPairs(pair<int, int>& var, Json::Value element)
     else // if element size is 0
     {
         cout << "Missing data\n";
+        return false;
     }
+    return true;
 }
-void assignPairs(pair<double, double>& var, Json::Value element)
+bool assignPairs(pair<double, double>& var, Json::Value element)
 {
     if (element.size() == 1)
     {
@@ -95,42 +135,45 @@ void assignPairs(pair<double, double>& var, Json::Value element)
     else // if element size is 0
     {
         cout << "Missing data\n";
+        return false;
     }
+    return true;
 }
 
-void PlantDictionary::loadProperties()
+bool PlantDictionary::loadProperties(const string& json)
 {
     Json::Reader reader;
     Json::Value root;
-    bool success = reader.parse(slurp("Content/plantproperties.json"), root);
+    bool success = reader.parse(json, root);
     if (!success)
     {
         cout << "Did not succeed: " << reader.getFormattedErrorMessages() << "\n";
-        return;
+        return false;
     }
 
+    bool complete = true;
     int counter = 0;
     while (!root[counter].isNull())
     {
         Json::Value plant = root[counter];
-        MasterPlantProperties pp;
+        MasterPlantProperties pp = MasterPlantProperties(); // Fields this species' JSON doesn't set are 0, the same in the catalog.
 
         pp.name = plant["name"].asString();
         pp.isAnnual = plant["annual"].asBool();
         if (!pp.isAnnual)
         {
-            assignPairs(pp.leafFallPeriod_r,  plant["leaf fall period"]);
-            assignPairs(pp.maxAge_r, plant["max age"]);
+            complete &= assignPairs(pp.leafFallPeriod_r,  plant["leaf fall period"]);
+            complete &= assignPairs(pp.maxAge_r, plant["max age"]);
         }
         pp.isTree = plant["is tree"].asBool();
         if (pp.isTree)
         {
-            assignPairs(pp.yearsUntilMaturity_r, plant["maturity"]);
-            assignPairs(pp.vegetativeMaturity_r, plant["vegetative maturity"]);
-            assignPairs(pp.maxYearlyGrowth_r, plant["max yearly growth"]);
+            complete &= assignPairs(pp.yearsUntilMaturity_r, plant["maturity"]);
+            complete &= assignPairs(pp.vegetativeMaturity_r, plant["vegetative maturity"]);
+            complete &= assignPairs(pp.maxYearlyGrowth_r, plant["max yearly growth"]);
         }
 
-        assignPairs(pp.maxLAI_r, plant["maxLAI"]);
+        complete &= assignPairs(pp.maxLAI_r, plant["maxLAI"]);
         if (plant["uses custom LAI graph"].asBool())
         {
             double leftroot = plant["LAI graph"]["left root"].asDouble();
@@ -148,9 +191,9 @@ void PlantDictionary::loadProperties()
         pp.growthStages[9] = plant["stage 9"].asDouble();
         pp.growthStages[10] = plant["stage 10"].asDouble();
         pp.baseTemp = plant["base temp"].asDouble();
-        assignPairs(pp.waterTolerence_r, plant["water tolerence"]);
-        assignPairs(pp.maxHeight_r, plant["max height"]);
-        assignPairs(pp.maxRootDepth_r, plant["max root depth"]);
+        complete &= assignPairs(pp.waterTolerence_r, plant["water tolerence"]);
+        complete &= assignPairs(pp.maxHeight_r, plant["max height"]);
+        complete &= assignPairs(pp.maxRootDepth_r, plant["max root depth"]);
         pp.startingNitrogenConcentration = plant["starting nitrogen"].asDouble();
         pp.finalNitrogenConcentration = plant["final nitrogen"].asDouble();
         pp.dayNeutral = plant["day neutral"].asBool();
@@ -241,42 +284,65 @@ void PlantDictionary::loadProperties()
 
         pp.minGerminationTemp = plant["germination"]["min temp"].asDouble();
         pp.optimalGerminationTemp = plant["germination"]["optimal temp"].asDouble();
-        assignPairs(pp.averageFruitWeight_r, plant["average fruit weight"]);
-        assignPairs(pp.seedRatio_r, plant["seed ratio"]);
+        complete &= assignPairs(pp.averageFruitWeight_r, plant["average fruit weight"]);
+        complete &= assignPairs(pp.seedRatio_r, plant["seed ratio"]);
         pp.dormancy = plant["seed dormancy"].asInt();
         pp.seedViability = plant["seed viability"].asDouble();
 
         pp.HeatUnitFactorNums = SCurve(1, 17, 0.18);
         pp.CO2CurveFactors = SCurve(0.1, 0.04, 49);
 
-        pp.biomassToVPD = 7;
+        pp.biomassToVPD = 72;
+        pp.nightLengthCurve = BasePlant::getSCurve(pp.dayNeutral, pp.longDayPlant, pp.minimumInduction, pp.criticalNightLength);
+        pp.lifeForm = pp.findLifeForm();
 
-        propertieslist[pp.name] = pp;
+        // Plants point into propertieslist, so it can't grow once plants exist. Nothing reloads it after init().
+        pp.speciesID = speciesNames.intern(pp.name);
+        if (pp.speciesID < (int)propertieslist.size())
+            propertieslist[pp.speciesID] = pp;
+        else
+            propertieslist.push_back(pp);
         counter++;
     }
+    return complete;
 }
 
 string PlantDictionary::slurp(const string& filename)
 {
-    fstream file(filename.c_str());
-    string output; output.clear();
-    string buffer; buffer.clear();
-    while (!file.eof())
-    {
-        std::getline(file, buffer);
-        output.append(buffer + string("\n"));
-    }
-    return output;
+    // Binary, so the text and its hash come out the same on every platform.
+    ifstream file(filename.c_str(), ios::in | ios::binary);
+    if (!file)
+        return string();
+    return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
 }
 
 PlantProperties PlantDictionary::getPlant(const string& plantname)
 {
-    auto it = propertieslist.find(plantname);
-    if (it != propertieslist.end())
-        return it->second.convert(MendelModule);
+    return getPlant(speciesNames.find(plantname));
+}
+
+PlantProperties PlantDictionary::getPlant(const int& speciesID)
+{
+    if (speciesID >= 0 && speciesID < (int)propertieslist.size())
+        return propertieslist[speciesID].convert(MendelModule);
     return PlantProperties();
 }
 
+int PlantDictionary::getSpeciesCount()
+{
+    return propertieslist.size();
+}
+
+int PlantDictionary::findSpeciesID(const string& plantname)
+{
+    return speciesNames.find(plantname);
+}
+
+const MasterPlantProperties& PlantDictionary::getSpecies(const int& speciesID)
+{
+    return propertieslist[speciesID];
+}
+
 PlantVisualProperties PlantDictionary::getVisual(const string& plantname)
 {
     auto it = visuallist.find(plantname);
@@ -1,8 +1,10 @@
 #pragma once
 #include "json/json.h"
 #include "plantproperties.h"
+#include "interner.h"
 #include <map>
 #include <string>
+#include <vector>
 
 using std::string;
 
@@ -12,15 +14,22 @@ namespace ALMANAC
     {
     public:
         PlantDictionary();
-        void init();
-        void loadProperties();
-        void loadVisualProperties();
+        void init(); // From the species catalog, or from the JSON when the catalog is stale, compiling a new one.
+        bool loadProperties(const string& json); // False if the JSON doesn't parse or has something missing.
+        bool loadVisualProperties(const string& json);
+        bool loadCatalog(const string& filename, const unsigned int& sourceHash);
+        bool compileCatalog(const string& filename, const unsigned int& sourceHash); // Writes what is loaded now.
         string slurp(const string& filename);
         PlantProperties getPlant(const string& plantname);
+        PlantProperties getPlant(const int& speciesID); // Same as by name, without the string lookup.
         PlantVisualProperties getVisual(const string& plantname);
+        int getSpeciesCount();
+        int findSpeciesID(const string& plantname); // -1 if there is no such species.
+        const MasterPlantProperties& getSpecies(const int& speciesID);
 
     private:
-        std::map<string, MasterPlantProperties> propertieslist;
+        std::vector<MasterPlantProperties> propertieslist; // Indexed by speciesID
+        StringInterner speciesNames; // speciesID of each name
         std::map<string, PlantVisualProperties> visuallist;
     };
 }
@@ -4,6 +4,7 @@ using namespace ALMANAC;
 
 
 MendelianInheritance MendelModule;
+static SpeciesProperties noSpecies;
 
 BiomassHolder::BiomassHolder()
 {
@@ -46,11 +47,95 @@ RGB::RGB(int r1, int g1, int b1)
 //////////////
 //////////////
 
-PlantProperties MasterPlantProperties::convert(MendelianInheritance& mendel)
+int SpeciesProperties::findLifeForm() const
 {
-    PlantProperties out;
-    
-    out = *this;
+    int form = 0;
+    if (isTree)
+        form |= lfTREE;
+    if (isAnnual)
+        form |= lfANNUAL;
+    if (needsVernalization) // Being obligate only matters if it needs vernalization at all.
+        form |= isObligateVernalization ? lfVERNALIZATION | lfOBLIGATEVERNALIZATION : lfVERNALIZATION;
+    return form;
+}
+
+PlantProperties::PlantProperties()
+: speciesData(&noSpecies)
+{
+}
+
+PlantProperties::PlantProperties(const SpeciesProperties& species)
+: speciesData(&species)
+{
+}
+
+// The genes of a PlantProperties, in one place for genomeHash() and sameGenome().
+static void listGenes(const PlantProperties& pp, const PolyGene* genes[11])
+{
+    genes[0] = &pp.gene_maxLAI;
+    genes[1] = &pp.gene_waterTolerence;
+    genes[2] = &pp.gene_maxHeight;
+    genes[3] = &pp.gene_maxYearlyGrowth;
+    genes[4] = &pp.gene_maxRootDepth;
+    genes[5] = &pp.gene_averageFruitWeight;
+    genes[6] = &pp.gene_yearsUntilMaturity;
+    genes[7] = &pp.gene_vegetativeMaturity;
+    genes[8] = &pp.gene_maxAge;
+    genes[9] = &pp.gene_leafFallPeriod;
+    genes[10] = &pp.gene_seedRatio;
+}
+
+static void hashBytes(unsigned int& hash, const void* data, const int& size)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (int counter = 0; counter < size; counter++)
+        hash = (hash ^ bytes[counter]) * 16777619u; // FNV-1a
+}
+
+static void hashGene(unsigned int& hash, const PolyGene& gene)
+{
+    const double values[4] = { gene.trait1.first, gene.trait1.second, gene.trait2.first, gene.trait2.second };
+    const bool operators[4] = { gene.operator1.first, gene.operator1.second, gene.operator2.first, gene.operator2.second };
+    hashBytes(hash, values, sizeof(values));
+    hashBytes(hash, operators, sizeof(operators));
+}
+
+static bool sameGene(const PolyGene& left, const PolyGene& right)
+{
+    return left.trait1.first == right.trait1.first && left.trait1.second == right.trait1.second
+        && left.trait2.first == right.trait2.first && left.trait2.second == right.trait2.second
+        && left.operator1.first == right.operator1.first && left.operator1.second == right.operator1.second
+        && left.operator2.first == right.operator2.first && left.operator2.second == right.operator2.second;
+}
+
+unsigned int PlantProperties::genomeHash() const
+{
+    const PolyGene* genes[11];
+    listGenes(*this, genes);
+    unsigned int hash = 2166136261u;
+    for (const PolyGene* gene : genes)
+        hashGene(hash, *gene);
+    return hash;
+}
+
+bool PlantProperties::sameGenome(const PlantProperties& other) const
+{
+    if (speciesData != other.speciesData)
+        return false;
+    const PolyGene* genes[11], *otherGenes[11];
+    listGenes(*this, genes);
+    listGenes(other, otherGenes);
+    for (int counter = 0; counter < 11; counter++)
+    {
+        if (!sameGene(*genes[counter], *otherGenes[counter]))
+            return false;
+    }
+    return true;
+}
+
+PlantProperties MasterPlantProperties::convert(MendelianInheritance& mendel) const
+{
+    PlantProperties out(*this);
 
     out.gene_maxLAI = mendel.spawnInRange(maxLAI_r);
 
@@ -139,7 +224,24 @@ double PlantProperties::seedRatio()
 
 void PlantVisualProperties::randomizeLerp()
 {
-    lerp = MendelModule.spawnInRange(0, 1);
+    randomizeLerp(MendelModule);
+}
+
+void PlantVisualProperties::randomizeLerp(MendelianInheritance& mendel)
+{
+    lerp = mendel.spawnInRange(0, 1);
+}
+
+unsigned int PlantVisualProperties::lerpHash() const
+{
+    unsigned int hash = 2166136261u;
+    hashGene(hash, lerp);
+    return hash;
+}
+
+bool PlantVisualProperties::sameLook(const PlantVisualProperties& other) const
+{
+    return ID == other.ID && sameGene(lerp, other.lerp);
 }
 
 RGB PlantVisualProperties::getColor()
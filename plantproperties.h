@@ -32,29 +32,36 @@ namespace ALMANAC
     struct PlantVisualProperties
     {
         void randomizeLerp();
+        void randomizeLerp(MendelianInheritance& mendel);
         std::string ID, name, name_plural, seedname, seedname_plural;
         int icon_sprout, icon_vegetative, icon_mature;
         bool isCover;
         bool whiteBackground; // Usually TRUE for dark-colored plants for contrast in the side bar
         RGB color1, color2;
         RGB getColor();
+        unsigned int lerpHash() const; // Same lerp gives the same hash.
+        bool sameLook(const PlantVisualProperties& other) const; // Same ID and same lerp.
 
     protected:
         PolyGene lerp;
     };
 
-    /// This class has intristic properties that do not change over the lifetime of a plant, eg its max LAI, growth stages, and various constants.
-    struct PlantProperties
+    /// Species flags that change which code a plant runs each day. A species' lifeForm is these or'd together.
+    enum LIFEFORM { lfTREE = 1, lfANNUAL = 2, lfVERNALIZATION = 4, lfOBLIGATEVERNALIZATION = 8, lfCOMBINATIONS = 16 };
+
+    // Every specialization of a kernel templated on the lifeForm, in a table to index by SpeciesProperties::lifeForm.
+#define LIFEFORM_KERNELS(kernel) { &kernel<0>, &kernel<1>, &kernel<2>, &kernel<3>, &kernel<4>, &kernel<5>, &kernel<6>, &kernel<7>, \
+    &kernel<8>, &kernel<9>, &kernel<10>, &kernel<11>, &kernel<12>, &kernel<13>, &kernel<14>, &kernel<15> }
+
+    /// This class has intristic properties that do not change over the lifetime of a plant and are the same for its whole species, eg its growth stages, curves and various constants.
+    /// There is one per species, kept by the plant dictionary, and plants only point to it.
+    struct SpeciesProperties
     {
         std::string name;
+        int speciesID = -1; // Index of the species in the plant dictionary, -1 if it doesn't come from it.
 
-        double maxLAI();
         std::map<int, double> growthStages;
         double baseTemp; // C, for GDD calcs
-        double waterTolerence();
-        double maxHeight(); // mm
-        double maxYearlyGrowth(); // mm, trees only
-        double maxRootDepth();
         SCurve HeatUnitFactorNums; // how fast it grows, shared atm
         SCurve CO2CurveFactors;  /// This one is shared for all plants.
         Parabola flowerTempCurve;
@@ -80,8 +87,6 @@ namespace ALMANAC
         double minGerminationTemp;
         double optimalGerminationTemp;
         double germinationThermalUnits;
-        double averageFruitWeight(); // kg
-        double seedRatio();
         double seedViability; // 0 <= x <= 1
         int dormancy;
 
@@ -101,15 +106,37 @@ namespace ALMANAC
         double minimumInduction;
         double criticalNightLength;
 
-        double biomassToVPD; // bc(3), =7
+        double biomassToVPD; // bc(3), =72
 
         bool isAnnual; // limits HU to the maturity HUs.    
         bool isTree;
+
+        int lifeForm = 0; // LIFEFORM flags. Has to be set to findLifeForm() again whenever the flags above change.
+        int findLifeForm() const;
+    };
+
+    /// The properties of one plant: the species it belongs to, and its own genes.
+    struct PlantProperties
+    {
+        PlantProperties(); // Belongs to no species, species() is left default.
+        PlantProperties(const SpeciesProperties& species);
+        const SpeciesProperties& species() const { return *speciesData; }
+
+        double maxLAI();
+        double waterTolerence();
+        double maxHeight(); // mm
+        double maxYearlyGrowth(); // mm, trees only
+        double maxRootDepth();
+        double averageFruitWeight(); // kg
+        double seedRatio();
         int yearsUntilMaturity(); // trees only
         int vegetativeMaturity(); // same
         int maxAge();
         int leafFallPeriod(); // days. over how many days the plant loses its LAI.
 
+        unsigned int genomeHash() const; // Same genes give the same hash.
+        bool sameGenome(const PlantProperties& other) const; // Same species and same genes.
+
         PolyGene gene_maxLAI;
         PolyGene gene_waterTolerence;
         PolyGene gene_maxHeight;
@@ -121,12 +148,15 @@ namespace ALMANAC
         PolyGene gene_maxAge;
         PolyGene gene_leafFallPeriod;
         PolyGene gene_seedRatio;
+
+    private:
+        const SpeciesProperties* speciesData;
     };
 
     // Stores the range of variables when applicable, and can be converted to a PlantProperties with genes.
-    struct MasterPlantProperties : public PlantProperties
+    struct MasterPlantProperties : public SpeciesProperties
     {
-        PlantProperties convert(MendelianInheritance& mendel);
+        PlantProperties convert(MendelianInheritance& mendel) const;
 
 
 
@@ -4,26 +4,47 @@
 
 using namespace ALMANAC;
 
-Seed::Seed()
-: germinated(false), germinationCounter(0)
+SeedCohort::SeedCohort()
+: germinated(false), count(0), seedBiomass(0), genomeHash(0), germinationCounter(0)
 {
     age = 0;
 }
 
-Seed::Seed(const PlantProperties& PP, const PlantVisualProperties& VP, const Month& Date, const int& dormancy, const double& seed, const double fruit)
-: germinated(false), germinationCounter(0), age(0)
+SeedCohort::SeedCohort(const PlantProperties& PP, const PlantVisualProperties& VP, const Month& Date, const int& dormancy)
+: germinated(false), count(0), seedBiomass(0), age(0), germinationCounter(0)
 {
     pp = PP;
     vp = VP;
-    seedBiomass = seed;
-    fruitBiomass = fruit;
     dormantDays = dormancy;
     date = Date;
+    genomeHash = pp.genomeHash();
 
-    germinationCurve = Parabola(pp.minGerminationTemp, pp.optimalGerminationTemp, 1.0);
+    germinationCurve = Parabola(pp.species().minGerminationTemp, pp.species().optimalGerminationTemp, 1.0);
 }
 
-bool Seed::attemptGerminate(const WeatherData& wd)
+void SeedCohort::addSeed(const double& seed)
+{
+    count++;
+    seedBiomass += seed;
+}
+
+bool SeedCohort::holds(const PlantProperties& PP, const Month& Date) const
+{
+    // Seeds from other days have seen different weather, so only seeds made on the same day share a cohort.
+    return date == Date && &pp.species() == &PP.species() && genomeHash == PP.genomeHash() && pp.sameGenome(PP);
+}
+
+double SeedCohort::averageSeedBiomass() const
+{
+    return count > 0 ? seedBiomass / count : 0;
+}
+
+int SeedCohort::getDormantDaysLeft(const Month& today) const
+{
+    return std::max(0, dormantDays + 1 - (today - date));
+}
+
+bool SeedCohort::attemptGerminate(const WeatherData& wd)
 {
     age++;
 
@@ -36,8 +57,8 @@ bool Seed::attemptGerminate(const WeatherData& wd)
     germinationCounter += max(0.0, germinationCurve.getValue((wd.minTemp + wd.maxTemp) / 2.0));
 
 
-    if (germinationCounter > pp.germinationThermalUnits)
+    if (germinationCounter > pp.species().germinationThermalUnits)
         germinated = true;
 
     return germinated;
-}
\ No newline at end of file
+}
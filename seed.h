@@ -8,22 +8,34 @@ namespace ALMANAC
 {
     class BasePlant;
 
-    class Seed
+    /**
+    Seeds in the soil that came from plants with the same genes on the same day. They see the same weather and
+    wait out the same dormancy, so they all germinate together: the cohort keeps one germination counter, a count
+    and a total weight instead of a copy of the properties for every seed. Every plant that grows out of it gets
+    the average seed weight.
+    **/
+    class SeedCohort
     {
     public:
-        Seed();
-        Seed(const PlantProperties& PP, const PlantVisualProperties& VP, const Month& Date, const int& dormancy, const double& seed, const double fruit = 0);
+        SeedCohort();
+        SeedCohort(const PlantProperties& PP, const PlantVisualProperties& VP, const Month& Date, const int& dormancy);
         PlantProperties pp;
         PlantVisualProperties vp;
 
+        void addSeed(const double& seed); // kg
+        bool holds(const PlantProperties& PP, const Month& Date) const; // If a seed from a plant with PP made on Date belongs here.
+        double averageSeedBiomass() const;
+        int getDormantDaysLeft(const Month& today) const; // 0 once attemptGerminate() can make progress.
+
         bool attemptGerminate(const WeatherData& wd);
 
         bool germinated;
         int dormantDays;
 
-        double seedBiomass;
-        double fruitBiomass; // for fleshy fruits like apples.
+        int count;
+        double seedBiomass; // kg, of all the seeds together.
         Month date;
+        unsigned int genomeHash; // PP.genomeHash(), to tell cohorts apart quickly.
 
     protected:
         int age;
@@ -32,4 +44,4 @@ namespace ALMANAC
 
     };
 
-}
\ No newline at end of file
+}
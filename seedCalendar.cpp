@@ -0,0 +1,59 @@
+#include "seedCalendar.h"
+
+using namespace ALMANAC;
+
+SeedCalendar::SeedCalendar()
+: slots(seedCalendarDays)
+{
+}
+
+void SeedCalendar::park(const int& index, const SeedCohort& seeds, const unsigned int& wakeDay)
+{
+    ParkedSeeds parked = { index, wakeDay, seeds };
+    slots[wakeDay % seedCalendarDays].push_back(parked);
+}
+
+void SeedCalendar::takeDue(const unsigned int& day, std::vector<ParkedSeeds>& due)
+{
+    std::vector<ParkedSeeds>& slot = slots[day % seedCalendarDays];
+    int kept = 0;
+    for (int counter = 0; counter < (int)slot.size(); counter++)
+    {
+        if (slot[counter].wakeDay <= day)
+            due.push_back(slot[counter]);
+        else
+        {
+            if (kept != counter)
+                slot[kept] = slot[counter];
+            kept++;
+        }
+    }
+    slot.erase(slot.begin() + kept, slot.end());
+}
+
+int SeedCalendar::getSeedCount(const int& index) const
+{
+    int count = 0;
+    for (const std::vector<ParkedSeeds>& slot : slots)
+        for (const ParkedSeeds& parked : slot)
+            if (parked.index == index)
+                count += parked.seeds.count;
+    return count;
+}
+
+void SeedCalendar::clear(const int& index)
+{
+    for (std::vector<ParkedSeeds>& slot : slots)
+    {
+        int kept = 0;
+        for (int counter = 0; counter < (int)slot.size(); counter++)
+        {
+            if (slot[counter].index == index)
+                continue;
+            if (kept != counter)
+                slot[kept] = slot[counter];
+            kept++;
+        }
+        slot.erase(slot.begin() + kept, slot.end());
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+#include "seed.h"
+
+namespace ALMANAC
+{
+    const int seedCalendarDays = 512; // Slots in the wheel. Longer waits go round more than once.
+
+    struct ParkedSeeds
+    {
+        int index; // The cell the seeds are in.
+        unsigned int wakeDay;
+        SeedCohort seeds;
+    };
+
+    /**
+    Holds seeds through their dormancy so nothing looks at them until it is over. A timing wheel: a seed is
+    parked in the slot for its wake day, modulo the wheel's length, and each day only that day's slot is looked at.
+    Seeds that wait longer than one turn of the wheel stay in their slot and are passed over until their turn comes.
+    **/
+    class SeedCalendar
+    {
+    public:
+        SeedCalendar();
+        void park(const int& index, const SeedCohort& seeds, const unsigned int& wakeDay);
+        void takeDue(const unsigned int& day, std::vector<ParkedSeeds>& due); // Adds the seeds waking on day to due, in the order they were parked.
+        int getSeedCount(const int& index) const; // Seeds parked for the cell.
+        void clear(const int& index); // Drops every seed parked for the cell.
+
+    private:
+        std::vector<std::vector<ParkedSeeds>> slots;
+    };
+}
@@ -8,20 +8,53 @@
 using namespace ALMANAC;
 using namespace std;
 
-const double BL = 20; // nitrogen leaching parameter
-
 const double SoilLayer::soilWeight = 1200;
 
 
 SoilLayer::SoilLayer(const double& sandi, const double& clayi, const double& silti, const double& organicMatteri, unsigned int thickness)
 :sand(sandi), clay(clayi), silt(silti), organicMatter(organicMatteri), depth(thickness), isTopsoil(false), isAquifer(false)
-, water(0), nitrates(5.604), organicMatterWeight(50.4), plantmatter(0)
+, water(0), nitrates(5.604), organicMatterWeight(50.4), plantmatter(0), columns(0), slot(0)
+{
+    propertyIndex = SOIL_MODELS::SoilPropertyTable::find(sand, silt, clay, organicMatter);
+
+}
+
+SoilLayer::SoilLayer(const SoilLayer& other)
+: previousWater(other.previousWater), sand(other.sand), clay(other.clay), silt(other.silt), organicMatter(other.organicMatter),
+organicMatterWeight(other.organicMatterWeight), plantmatter(other.plantmatter), propertyIndex(other.propertyIndex),
+water(other.totalWater()), nitrates(other.getNitrates()), depth(other.depth), percolateDown(other.percolateDown), percolateUp(other.percolateUp),
+lateral(other.lateral), movedNitrates(other.movedNitrates), isTopsoil(other.isTopsoil), isAquifer(other.isAquifer), columns(0), slot(0)
 {
-    properties = SOIL_MODELS::SoilModule::fetch(sand, silt, clay, organicMatter);
+}
 
+SoilLayer& SoilLayer::operator=(const SoilLayer& other)
+{
+    if (this != &other)
+    {
+        previousWater = other.previousWater;
+        sand = other.sand;
+        clay = other.clay;
+        silt = other.silt;
+        organicMatter = other.organicMatter;
+        organicMatterWeight = other.organicMatterWeight;
+        plantmatter = other.plantmatter;
+        propertyIndex = other.propertyIndex;
+        water = other.totalWater();
+        nitrates = other.getNitrates();
+        depth = other.depth;
+        percolateDown = other.percolateDown;
+        percolateUp = other.percolateUp;
+        lateral = other.lateral;
+        movedNitrates = other.movedNitrates;
+        isTopsoil = other.isTopsoil;
+        isAquifer = other.isAquifer;
+        columns = 0;
+        slot = 0;
+    }
+    return *this;
 }
 
-double SoilLayer::getDepth()
+double SoilLayer::getDepth() const
 {
     return depth;
 }
@@ -32,6 +65,7 @@ void SoilLayer::percolateAndLateral(const double& slope)
     percolateDown = 0;
     percolateUp = 0;
     lateral = 0;
+    double& water = waterRef();
     if (water > fieldCapacity() + 0.000001f)
     {
         double lateralFlowTime = travelTime() / (slope / 1000.0f);
@@ -43,56 +77,68 @@ void SoilLayer::percolateAndLateral(const double& slope)
     previousWater = percolationWater();
 
     movedNitrates = findMovedNitrates(percolateDown + percolateUp + lateral);
-    nitrates -= movedNitrates;
+    nitrateRef() -= movedNitrates;
 }
 
-double SoilLayer::totalWaterMoved()
+double SoilLayer::totalWaterMoved() const
 {
     return percolateDown + percolateUp + lateral;
 }
 
-double SoilLayer::totalWater()
+double SoilLayer::totalWater() const
 {
-    return water;
+    return columns ? columns->water[slot] : water;
 }
 
-double SoilLayer::wiltingPoint()
+double SoilLayer::wiltingPoint() const
 {
-    return properties.wiltingPoint * depth;
+    return properties().wiltingPoint * depth;
 }
 
-double SoilLayer::fieldCapacity()
+double SoilLayer::fieldCapacity() const
 {
-    return properties.fieldCapacity * depth;
+    return properties().fieldCapacity * depth;
 }
 
-double SoilLayer::saturatedMoisture()
+double SoilLayer::saturatedMoisture() const
 {
-    return properties.saturatedMoisture * depth;
+    return properties().saturatedMoisture * depth;
 }
 
-double SoilLayer::SatHydConductivity()
+double SoilLayer::SatHydConductivity() const
 {
-    return properties.SatHydConductivity;
+    return properties().SatHydConductivity;
 }
 
-double SoilLayer::travelTime()
+double SoilLayer::travelTime() const
 {
-    return properties.travelTime;
+    return properties().travelTime;
 }
 
 void SoilLayer::addWater(const double& addwater)
 {
-    water += addwater;
+    waterRef() += addwater;
+}
+
+double SoilLayer::getNitrates() const
+{
+    return columns ? columns->nitrates[slot] : nitrates;
 }
 
-double SoilLayer::availableWater()
+void SoilLayer::addNitrates(const double& amount)
 {
+    nitrateRef() += amount;
+}
+
+double SoilLayer::availableWater() const
+{
+    double water = totalWater();
     return (water - wiltingPoint()) > 0 ? (water - wiltingPoint()) : 0;
 }
 
-double SoilLayer::percolationWater()
+double SoilLayer::percolationWater() const
 {
+    double water = totalWater();
     return (water - fieldCapacity()) > 0 ? (water - fieldCapacity()) : 0;
 }
 
@@ -103,6 +149,7 @@ double SoilLayer::withdrawWater(const double& amount, const int numPlants)
 
 double SoilLayer::withdrawWater(const double& amount, const double& rootdepth, const int numPlants)
 {
+    double& water = waterRef();
     double supply = 0;
     double depthFraction = rootdepth / depth;
     if (depthFraction > 1) depthFraction = 1;
@@ -139,6 +186,8 @@ double SoilLayer::withdrawNitrogen(const double& amount, const double& waterUpta
 
 double SoilLayer::withdrawNitrogen(const double& amount, const double& waterUptake, const double& rootDepth)
 {
+    double& water = waterRef();
+    double& nitrates = nitrateRef();
     double supply = 0;
 
     double maxNitrogen = waterUptake / water * nitrates;
@@ -160,6 +209,8 @@ double SoilLayer::withdrawNitrogen(const double& amount, const double& waterUpta
 
 void SoilLayer::denitrification(const double temp)
 {
+    double& water = waterRef();
+    double& nitrates = nitrateRef();
     double SWF = water / fieldCapacity(); // soil water / field capacity
     double denitr = 0;
     double tempFactor = max(0.1, temp / (temp + exp(9.93 - 0.312 * temp)));
@@ -171,7 +222,7 @@ void SoilLayer::denitrification(const double temp)
 
 double SoilLayer::findMovedNitrates(const double& waterVolume)
 {
-    return nitrates * (1 - exp(-waterVolume / (saturatedMoisture() * BL)));
+    return nitrateRef() * (1 - exp(-waterVolume / (saturatedMoisture() * BL)));
 }
 
 void SoilLayer::adjustWater()
@@ -193,7 +244,7 @@ void SoilLayer::adjustWater()
 
 
 SoilCell::SoilCell()
-: surfaceWater(0), snow(0)
+: plantsStarted(0), surfaceWater(0), snow(0)
 {
     for (int counter = 0; counter < 8; counter++)
         flowInputs[counter] = 0;
@@ -204,14 +255,14 @@ void SoilCell::upwardsFlow()
     Layers.front().percolateUp = 0;
     for (auto it = Layers.begin() + 1; it < Layers.end(); it++)
     {
-        if (it->water > it->fieldCapacity())
-            it->percolateUp = (it->percolationWater())*(1 - exp(0.05*((it - 1)->water / (it - 1)->fieldCapacity() - it->water / it->fieldCapacity())));
+        if (it->totalWater() > it->fieldCapacity())
+            it->percolateUp = (it->percolationWater())*(1 - exp(0.05*((it - 1)->totalWater() / (it - 1)->fieldCapacity() - it->totalWater() / it->fieldCapacity())));
         if (it->percolateUp < 0)
             it->percolateUp = 0;
     } // for each layer, run the algorithm. Exclude the top layer.
 }
 
-vector<double> SoilCell::inspectWater()
+vector<double> SoilCell::inspectWater() const
 {
     vector<double> output;
     for (auto i = Layers.begin(); i < Layers.end(); i++)
@@ -221,34 +272,31 @@ vector<double> SoilCell::inspectWater()
     return output;
 }
 
-vector<double> SoilCell::inspectNitrates()
+double SoilCell::inspectWater(const int& layer) const
+{
+    return Layers[layer].availableWater();
+}
+
+double SoilCell::inspectNitrates(const int& layer) const
+{
+    return Layers[layer].getNitrates();
+}
+
+vector<double> SoilCell::inspectNitrates() const
 {
     vector<double> output;
     for (auto i = Layers.begin(); i < Layers.end(); i++)
     {
-        output.push_back(i->nitrates);
+        output.push_back(i->getNitrates());
     }
     return output;
 }
 
-void SoilCell::doSnowmelt(const double temp)
+void SoilCell::doSnowmelt(const double meltFraction)
 {
-    if (temp > 0)
-    {
-        double meltPercentage = log(temp + 1.0) / log(10.0);
-        meltPercentage = min(1.0, meltPercentage);
-        double meltedSnow = snow * meltPercentage;
-        snow -= meltedSnow;
-        surfaceWater += meltedSnow;
-    }
-    else
-    {
-        double meltPercentage = log(temp + 1.0) / log(10.0);
-        meltPercentage = min(1.0, meltPercentage);
-        double meltedSnow = snow * 0.01;
-        snow -= meltedSnow;
-        surfaceWater += meltedSnow;
-    }
+    double meltedSnow = snow * meltFraction;
+    snow -= meltedSnow;
+    surfaceWater += meltedSnow;
 
     if (snow < 0.00001)
         snow = 0;
@@ -257,7 +305,7 @@ void SoilCell::doSnowmelt(const double temp)
 void SoilCell::solveAndPercolate()
 {
     // First add whatever surface water possible to the top layer. Need to implement runoff sooner or later.
-    double possibleWater = Layers.front().saturatedMoisture() - Layers.front().water;
+    double possibleWater = Layers.front().saturatedMoisture() - Layers.front().totalWater();
     if (surfaceWater < possibleWater)
         possibleWater = surfaceWater;
     surfaceWater -= possibleWater;
@@ -287,7 +335,7 @@ void SoilCell::solveAndPercolate()
             it->addWater(-possible);
 
             if (it->totalWaterMoved() > 0)
-                (it + 1)->nitrates += it->movedNitrates / it->totalWaterMoved() * possible;
+                (it + 1)->addNitrates(it->movedNitrates / it->totalWaterMoved() * possible);
         }
 
         if (!it->isTopsoil) //perc up
@@ -302,7 +350,7 @@ void SoilCell::solveAndPercolate()
             it->addWater(-possible);
 
             if (it->totalWaterMoved() > 0)
-                (it - 1)->nitrates += it->movedNitrates / it->totalWaterMoved() * possible;
+                (it - 1)->addNitrates(it->movedNitrates / it->totalWaterMoved() * possible);
         }
 
         if (it->isAquifer)
@@ -328,10 +376,60 @@ void SoilCell::calculateNitrogen(const double temp)
 }
 
 std::vector<SoilLayer> SoilCell::getLayers()
+{
+    return std::vector<SoilLayer>(Layers.begin(), Layers.end());
+}
+
+const SoilLayers& SoilCell::viewLayers() const
 {
     return Layers;
 }
 
+int SoilCell::getLayerCount() const
+{
+    return Layers.size();
+}
+
+SeedCohort& SoilCell::findSeedCohort(const PlantProperties& pp, const PlantVisualProperties& vp, const Month& date)
+{
+    for (SeedCohort& cohort : seeds)
+        if (cohort.holds(pp, date))
+            return cohort;
+    seeds.push_back(SeedCohort(pp, vp, date, pp.species().dormancy));
+    return seeds.back();
+}
+
+int SoilCell::getSeedCount() const
+{
+    int count = 0;
+    for (const SeedCohort& cohort : seeds)
+        count += cohort.count;
+    return count;
+}
+
+#ifndef STANDALONE
+void SoilCell::addSeedItems(const int& speciesID, const unsigned int& genome, const int& count)
+{
+    for (HerbSim::SeedItem& item : items)
+    {
+        if (item.genome == genome && item.speciesID == speciesID)
+        {
+            item.count += count;
+            return;
+        }
+    }
+    items.push_back(HerbSim::SeedItem(speciesID, genome, count));
+}
+
+int SoilCell::getItemCount() const
+{
+    int count = 0;
+    for (const HerbSim::SeedItem& item : items)
+        count += item.count;
+    return count;
+}
+#endif
+
 void SoilCell::addWater(const int& layer, const double& amount)
 {
     if (layer < Layers.size())
@@ -340,9 +438,9 @@ void SoilCell::addWater(const int& layer, const double& amount)
 
 std::ostream& operator<< (std::ostream& o, ALMANAC::SoilCell& sc)
 {
-    auto copy = sc.getLayers();
-    for (auto it = copy.begin(); it < copy.end(); it++)
-        o << it->nitrates << "\t";
+    const SoilLayers& layers = sc.viewLayers();
+    for (auto it = layers.begin(); it < layers.end(); it++)
+        o << it->getNitrates() << "\t";
     o << "\n";
     return o;
 }
@@ -358,12 +456,12 @@ void SoilCell::calcTotalHeight()
     totalHeight = total;
 }
 
-double SoilCell::getTotalHeight()
+double SoilCell::getTotalHeight() const
 {
     return totalHeight;
 }
 
-soiltuple SoilCell::getTopLayer()
+soiltuple SoilCell::getTopLayer() const
 {
     soiltuple output;
     output.sand = Layers.front().sand;
@@ -372,12 +470,12 @@ soiltuple SoilCell::getTopLayer()
     return output;
 }
 
-int SoilCell::getTopsoilType()
+int SoilCell::getTopsoilType() const
 {
     return topsoilType;
 }
 
-int SoilCell::getTopsoilGroup()
+int SoilCell::getTopsoilGroup() const
 {
     return topsoilGroup;
 }
@@ -387,12 +485,12 @@ void SoilCell::setMooreDirection(const int& moore)
     MooreDirection = moore;
 }
 
-int SoilCell::getMooreDirection()
+int SoilCell::getMooreDirection() const
 {
     return MooreDirection;
 }
 
-void SoilCell::transferLateralWater(std::vector<SoilLayer>& OutLayers)
+void SoilCell::transferLateralWater(SoilLayers& OutLayers)
 {
     assert(Layers.size() == OutLayers.size());
     auto otherit = OutLayers.begin();
@@ -472,6 +570,7 @@ SoilCell* SoilFactory::createTestCell()
 SoilCell SoilFactory::createCell(const double& baseheight, const double& depth, std::vector<soiltuple>& st)
 {
     SoilCell output;
+    output.Layers.reserve(st.size());
     for (auto it = st.begin(); it < st.end(); it++)
     {
         output.Layers.push_back(SoilLayer(it->sand, it->silt, it->clay, 0.05, depth));
@@ -544,13 +643,14 @@ SoilLayer& SoilCell::getFront(const int& offset)
 void SoilCell::addNitrogenToTop(const double& amount)
 {
     if (Layers.size() != 0)
-        Layers.front().nitrates += amount;
+        Layers.front().addNitrates(amount);
 }
 
 void SoilLayer::recharge()
 {
     if (isAquifer)
     {
+        double& water = waterRef();
         if (water < fieldCapacity())
             water += min((fieldCapacity() - water) / fieldCapacity() * 10, fieldCapacity() - water);
     }
@@ -7,6 +7,8 @@
 #include "plant.h"
 #include "vector3.h"
 #include "config.h"
+#include "soilColumns.h"
+#include "inlineVector.h"
 #include <map>
 #ifndef STANDALONE
 #include "item.h"
@@ -17,10 +19,12 @@ namespace ALMANAC
 
 
     class SoilFactory;
-    class transferWater;
     class SoilCell;
     class SoilGrid;
 
+    const double BL = 20; // nitrogen leaching parameter
+    const int maxSoilLayers = 10; // Most layers a SoilCell can have, aquifer included.
+
     struct soiltuple
     {
         soiltuple(){}
@@ -33,17 +37,21 @@ namespace ALMANAC
         friend class SoilFactory;
         friend class SoilCell;
         friend class SoilGrid;
-        friend class transferWater;
+        friend class SoilColumns;
+
+        // A copy is never attached, even if other is. It takes the water and nitrates other has at the time.
+        SoilLayer(const SoilLayer& other);
+        SoilLayer& operator=(const SoilLayer& other);
 
         void addWater(const double& addwater);
-        double availableWater();
-        double percolationWater();
+        double availableWater() const;
+        double percolationWater() const;
 
-        virtual void recharge();
+        void recharge();
 
-        double getDepth();
-        double totalWaterMoved();
-        double totalWater();
+        double getDepth() const;
+        double totalWaterMoved() const;
+        double totalWater() const;
 
         double withdrawWater(const double& amount, const int numPlants = 0);
         double withdrawWater(const double& amount, const double &rootdepth, const int numPlants = 0);
@@ -51,23 +59,24 @@ namespace ALMANAC
         double withdrawNitrogen(const double& amount, const double& waterUptake);
         double withdrawNitrogen(const double& amount, const double& waterUptake, const double& rootDepth);
 
-        double nitrates; // kg / ha
+        double getNitrates() const; // kg / ha
+        void addNitrates(const double& amount);
 
-        double fieldCapacity();
-        double saturatedMoisture();
+        double fieldCapacity() const;
+        double saturatedMoisture() const;
 
         double previousWater;
 
     protected:
-        virtual void percolateAndLateral(const double& slope); // probably needs a parameter for the Moore direction
+        void percolateAndLateral(const double& slope); // probably needs a parameter for the Moore direction
         double findMovedNitrates(const double& waterVolume);
 
 
         SoilLayer(const double& sandi, const double& clayi, const double& silti, const double& organicMatteri, unsigned int thickness = 200);
-        double wiltingPoint();
+        double wiltingPoint() const;
         void denitrification(const double temp);
-        double SatHydConductivity();
-        double travelTime();
+        double SatHydConductivity() const;
+        double travelTime() const;
         void adjustWater();
         double getSoilWeight(); // kg / ha
 
@@ -77,8 +86,10 @@ namespace ALMANAC
         double plantmatter; // kg / m^2
 
 
-        SoilProperties properties;
+        int propertyIndex; // Into SOIL_MODELS::SoilPropertyTable.
+        const SoilProperties& properties() const { return SOIL_MODELS::SoilPropertyTable::get(propertyIndex); }
         double water;
+        double nitrates; // kg / ha
         unsigned int depth; // thickness of the soil in mm.
         double percolateDown, percolateUp, lateral;
         double movedNitrates;
@@ -86,45 +97,52 @@ namespace ALMANAC
         bool isTopsoil; // = isTopsoil
         bool isAquifer; // = isAquifer
 
+        // When attached to a grid's SoilColumns, water and nitrates live there instead of in this layer.
+        // Only SoilColumns::attach() sets these.
+        SoilColumns* columns;
+        int slot;
+        double& waterRef() { return columns ? columns->water[slot] : water; }
+        double& nitrateRef() { return columns ? columns->nitrates[slot] : nitrates; }
+
     private:
         static const double soilWeight; // kg / m^3
     };
 
-    class transferWater
-    {
-    public:
-        static void transfer(SoilCell& waterOut, SoilCell& destination);
-    };
+    typedef InlineVector<SoilLayer, maxSoilLayers> SoilLayers;
 
     class SoilCell // a group of soil layers, most likely 10 + shallow aquifer.
     {
     public:
-        friend class transferWater;
         friend class SoilFactory;
         friend class SoilGrid;
+        friend class SoilColumns;
 
         SoilCell();
 
         void addNitrogenToTop(const double& amount);
         void addWater(const int& layer, const double& amount);
 
-        void doSnowmelt(const double temp);
+        void doSnowmelt(const double meltFraction); // See DailyForcing::snowmeltFraction.
         void solveAndPercolate(); // Solve for percolation downwards and lateral flow for each layer, then put them in the respective outbound slots
         void calculateNitrogen(const double temp);
         double slope; // m/m
 
-        std::vector<double> inspectWater();
-        std::vector<double> inspectNitrates();
-        std::vector<SoilLayer> getLayers();
+        std::vector<double> inspectWater() const;
+        std::vector<double> inspectNitrates() const;
+        double inspectWater(const int& layer) const; // Same as inspectWater()[layer], without building the vector.
+        double inspectNitrates(const int& layer) const;
+        std::vector<SoilLayer> getLayers(); // A copy. Use viewLayers() to just look.
+        const SoilLayers& viewLayers() const;
+        int getLayerCount() const;
 
-        double getTotalHeight();
+        double getTotalHeight() const;
         void calcTotalHeight();
-        soiltuple getTopLayer();
-        int getTopsoilType();
-        int getTopsoilGroup();
+        soiltuple getTopLayer() const;
+        int getTopsoilType() const;
+        int getTopsoilGroup() const;
         void setMooreDirection(const int& moore);
-        int getMooreDirection();
-        void transferLateralWater(std::vector<SoilLayer>& OutLayers); // out of this cell into the other cell. Layer sizes MUST match, otherwise cerr.
+        int getMooreDirection() const;
+        void transferLateralWater(SoilLayers& OutLayers); // out of this cell into the other cell. Layer sizes MUST match, otherwise cerr.
         SoilLayer& getFront(const int& offset = 0);
 
         double requestWater(double rootDepth, double demand);
@@ -132,7 +150,10 @@ namespace ALMANAC
 
 
         std::vector<BasePlant> plants;
-        std::vector<Seed> seeds;
+        std::vector<SeedCohort> seeds; // The seed bank. Seeds in their dormancy are kept by the SoilGrid until it ends.
+        SeedCohort& findSeedCohort(const PlantProperties& pp, const PlantVisualProperties& vp, const Month& date); // Adds one if there is none yet.
+        int getSeedCount() const; // Not counting the dormant ones the SoilGrid keeps.
+        unsigned int plantsStarted; // How many plants have ever been put in this cell. Numbers their random streams.
 
 
         double surfaceWater;
@@ -140,14 +161,16 @@ namespace ALMANAC
         bool test_isUnderWater; //test
 
 #ifndef STANDALONE
-        std::map<std::string, HerbSim::MultiSeed> items;
+        void addSeedItems(const int& speciesID, const unsigned int& genome, const int& count); // Onto the pile with the same genes, if there is one.
+        int getItemCount() const; // Seeds in all the piles.
+        std::vector<HerbSim::SeedItem> items;
 #endif
 
     protected:
         void upwardsFlow();
         vector3 gradientVector; // |<x, y>| 'strength' of graient, <x, y> normal == direction of
         void scale(); // make sure that the water out doesn't exceed the total available water.
-        std::vector<SoilLayer> Layers;  // 0 is top, followed by 1 2 3 ...'
+        SoilLayers Layers;  // 0 is top, followed by 1 2 3 ...' Stored inside the cell, no allocation.
         
         int MooreDirection; // One vector for the whole cell. Follows the enum {Moore}.
         double flowAmount; // surface flow
@@ -0,0 +1,273 @@
+#include "soilColumns.h"
+#include "soil.h"
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+using namespace ALMANAC;
+using namespace std;
+
+
+// Whether the CPU can run AVX2 code, and the OS saves the wide registers it needs.
+static bool cpuHasAVX2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    const int osxsaveAndAVX = (1 << 27) | (1 << 28);
+    if ((info[2] & osxsaveAndAVX) != osxsaveAndAVX || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__)
+    __builtin_cpu_init(); // Runs before main(), maybe before the runtime has done it.
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+static const bool avx2Usable = cpuHasAVX2() && SoilColumns::hasAVX2Kernel(); // Looked up once, before main(). The CPU goes first.
+
+bool SoilColumns::usesAVX2()
+{
+    return avx2Usable;
+}
+
+SoilColumns::SoilColumns()
+: cells(0), layers(0)
+{
+}
+
+void SoilColumns::resize(const int& cellCount, const int& layerCount)
+{
+    cells = cellCount;
+    layers = layerCount;
+    int size = cells * layers;
+
+    water.assign(size, 0);
+    nitrates.assign(size, 0);
+    fieldCapacity.assign(size, 0);
+    saturatedMoisture.assign(size, 0);
+    travelTime.assign(size, 0);
+    percolateDown.assign(size, 0);
+    percolateUp.assign(size, 0);
+    lateral.assign(size, 0);
+    previousWater.assign(size, 0);
+    movedNitrates.assign(size, 0);
+    slope.assign(cells, 0);
+}
+
+void SoilColumns::attach(SoilCell& cell, const int& index)
+{
+    if (cell.Layers.size() != layers)
+    {
+        std::cerr << "Layer sizes do not match.";
+        abort();
+    }
+
+    for (int layer = 0; layer < layers; layer++)
+    {
+        SoilLayer& source = cell.Layers[layer];
+        int s = slot(index, layer);
+        water[s] = source.totalWater();
+        nitrates[s] = source.getNitrates();
+        fieldCapacity[s] = source.fieldCapacity();
+        saturatedMoisture[s] = source.saturatedMoisture();
+        travelTime[s] = source.travelTime();
+
+        source.columns = this; // Only the cell's own layers. Copies of them take what they hold and are detached.
+        source.slot = s;
+    }
+    slope[index] = cell.slope;
+}
+
+int SoilColumns::slot(const int& cell, const int& layer) const
+{
+    return layer * cells + cell;
+}
+
+int SoilColumns::getCellCount() const
+{
+    return cells;
+}
+
+int SoilColumns::getLayerCount() const
+{
+    return layers;
+}
+
+void SoilColumns::infiltrate(const int& cell, double& surfaceWater)
+{
+    double possibleWater = saturatedMoisture[cell] - water[cell]; // Layer 0 of a cell is simply its index.
+    if (surfaceWater < possibleWater)
+        possibleWater = surfaceWater;
+    surfaceWater -= possibleWater;
+    water[cell] += possibleWater;
+}
+
+void SoilColumns::solveAndPercolate(const int& begin, const int& end)
+{
+    // Each phase is run one layer at a time across the whole range, which keeps every
+    // inner loop on contiguous memory. Per cell the order of operations is unchanged.
+    for (int layer = 0; layer < layers; layer++)
+        percolateAndLateral(layer, begin, end);
+    for (int layer = 1; layer < layers; layer++)
+        upwardsFlow(layer, begin, end);
+    for (int layer = 0; layer < layers; layer++)
+        moveWater(layer, begin, end);
+}
+
+void SoilColumns::gatherLateral(const int& begin, const int& end, const std::vector<int>& upstreamStart, const std::vector<int>& upstream)
+{
+    // lateral is only written by solveAndPercolate, and each cell only adds to its own water,
+    // so the result does not depend on which cells are done first or by whom.
+    for (int layer = 0; layer < layers; layer++)
+    {
+        const int offset = layer * cells;
+        for (int cell = begin; cell < end; cell++)
+        {
+            double inflow = 0;
+            for (int counter = upstreamStart[cell]; counter < upstreamStart[cell + 1]; counter++)
+                inflow += lateral[offset + upstream[counter]];
+            water[offset + cell] += inflow;
+        }
+    }
+}
+
+bool SoilColumns::isSettled(const int& cell) const
+{
+    // Nothing percolates down or sideways out of a layer within the percolation threshold of field capacity,
+    // and the aquifer only recharges while it is below it. The only thing left is the upward flow of what
+    // little is above field capacity, which never gets a layer below the threshold, so it is let go.
+    for (int layer = 0; layer < layers; layer++)
+    {
+        if (water[slot(cell, layer)] > fieldCapacity[slot(cell, layer)] + 0.000001f)
+            return false;
+    }
+    const int aquifer = slot(cell, layers - 1);
+    return water[aquifer] >= fieldCapacity[aquifer];
+}
+
+void SoilColumns::clearLateral(const int& cell)
+{
+    for (int layer = 0; layer < layers; layer++)
+        lateral[slot(cell, layer)] = 0;
+}
+
+// See SoilLayer::percolateAndLateral
+void SoilColumns::percolateAndLateral(const int& layer, const int& begin, const int& end)
+{
+    int cell = begin;
+    if (usesAVX2())
+        cell = percolateAndLateralAVX2(layer, begin, end);
+    percolateAndLateralScalar(layer, cell, end);
+}
+
+void SoilColumns::percolateAndLateralScalar(const int& layer, const int& begin, const int& end)
+{
+    const int offset = layer * cells;
+    for (int cell = begin; cell < end; cell++)
+    {
+        const int s = offset + cell;
+        double down = 0, lat = 0;
+        if (water[s] > fieldCapacity[s] + 0.000001f)
+        {
+            double lateralFlowTime = travelTime[s] / (slope[cell] / 1000.0f);
+            double initialperc = (water[s] - fieldCapacity[s])*(1 - exp(-travelTime[s] * 24 - lateralFlowTime * 24));// "O + QH"
+            down = initialperc / (1 + 24 * travelTime[s]);
+            lat = initialperc / (1 + 24 * lateralFlowTime);
+        }
+        percolateDown[s] = down;
+        percolateUp[s] = 0;
+        lateral[s] = lat;
+
+        previousWater[s] = (water[s] - fieldCapacity[s]) > 0 ? (water[s] - fieldCapacity[s]) : 0;
+
+        movedNitrates[s] = nitrates[s] * (1 - exp(-(down + lat) / (saturatedMoisture[s] * BL)));
+        nitrates[s] -= movedNitrates[s];
+    }
+}
+
+// See SoilCell::upwardsFlow
+void SoilColumns::upwardsFlow(const int& layer, const int& begin, const int& end)
+{
+    const int offset = layer * cells;
+    for (int cell = begin; cell < end; cell++)
+    {
+        const int s = offset + cell;
+        const int above = s - cells;
+        if (water[s] > fieldCapacity[s])
+            percolateUp[s] = (water[s] - fieldCapacity[s])*(1 - exp(0.05*(water[above] / fieldCapacity[above] - water[s] / fieldCapacity[s])));
+        if (percolateUp[s] < 0)
+            percolateUp[s] = 0;
+    }
+}
+
+// See SoilLayer::adjustWater and the intracell part of SoilCell::solveAndPercolate
+void SoilColumns::moveWater(const int& layer, const int& begin, const int& end)
+{
+    const int offset = layer * cells;
+    const bool isTopsoil = layer == 0;
+    const bool isAquifer = layer == layers - 1;
+    for (int cell = begin; cell < end; cell++)
+    {
+        const int s = offset + cell;
+
+        if (isTopsoil) percolateUp[s] = 0;
+        double waterout = lateral[s] + percolateDown[s] + percolateUp[s];
+        if (waterout > previousWater[s]) // if water out is larger than available water.
+        {
+            double mult = previousWater[s] / waterout;
+            lateral[s] *= mult;
+            percolateUp[s] *= mult;
+            percolateDown[s] *= mult;
+        }
+        double totalMoved = percolateDown[s] + percolateUp[s] + lateral[s];
+
+        if (!isAquifer) //perc down
+        {
+            const int below = s + cells;
+            double possible = percolateDown[s];
+            if (water[below] + percolateDown[s] > saturatedMoisture[below])
+                possible = saturatedMoisture[below] - water[below];
+
+            water[below] += possible;
+            water[s] += -possible;
+
+            if (totalMoved > 0)
+                nitrates[below] += movedNitrates[s] / totalMoved * possible;
+        }
+
+        if (!isTopsoil) //perc up
+        {
+            const int above = s - cells;
+            double possible = percolateUp[s];
+            if (water[above] + percolateUp[s] > saturatedMoisture[above])
+                possible = saturatedMoisture[above] - water[above];
+
+            water[above] += possible;
+            water[s] += -possible;
+
+            if (totalMoved > 0)
+                nitrates[above] += movedNitrates[s] / totalMoved * possible;
+        }
+
+        if (isAquifer)
+        {
+            water[s] += -percolateDown[s];
+            // Recharge the water. See SoilLayer::recharge
+            if (water[s] < fieldCapacity[s])
+                water[s] += min((fieldCapacity[s] - water[s]) / fieldCapacity[s] * 10, fieldCapacity[s] - water[s]);
+        }
+
+        water[s] += -lateral[s];
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <vector>
+
+namespace ALMANAC
+{
+    class SoilCell;
+
+    /**
+    A structure-of-arrays store for the per-layer soil state of a whole grid.
+    Every field is a contiguous array per layer, indexed as [layer * cellCount + cell],
+    so the daily water step walks flat arrays instead of chasing each cell's layer vector.
+    SoilLayers that are attached to a store read and write their water and nitrates here.
+    **/
+    class SoilColumns
+    {
+        friend class Tests;
+    public:
+        SoilColumns();
+        void resize(const int& cellCount, const int& layerCount);
+        void attach(SoilCell& cell, const int& index); // Copies the cell's layer state in and binds its layers to this store.
+
+        int slot(const int& cell, const int& layer) const;
+        int getCellCount() const;
+        int getLayerCount() const;
+
+        void infiltrate(const int& cell, double& surfaceWater); // Moves what surface water the top layer can hold into it.
+        void solveAndPercolate(const int& begin, const int& end); // Same as SoilCell::solveAndPercolate, for cells [begin, end).
+        // Adds the lateral outflow of each cell's upstream cells to it, for cells [begin, end).
+        // The cells draining into cell c are upstream[upstreamStart[c]] .. upstream[upstreamStart[c + 1] - 1].
+        void gatherLateral(const int& begin, const int& end, const std::vector<int>& upstreamStart, const std::vector<int>& upstream);
+        bool isSettled(const int& cell) const; // True if solveAndPercolate would only move a negligible amount of water in the cell, given no surface water.
+        void clearLateral(const int& cell); // Zeroes the cell's lateral outflow, for cells that stop being solved.
+        static bool hasAVX2Kernel(); // soilColumnsAVX2.cpp was built with AVX2.
+        static bool usesAVX2(); // That, and this CPU can run it, so percolation goes four cells at a time.
+
+        // Layer state
+        std::vector<double> water, nitrates;
+        std::vector<double> fieldCapacity, saturatedMoisture, travelTime; // fieldCapacity & saturatedMoisture are already multiplied by depth.
+        // Scratch, only valid during solveAndPercolate
+        std::vector<double> percolateDown, percolateUp, lateral, previousWater, movedNitrates;
+        // Cell state
+        std::vector<double> slope;
+
+    private:
+        void percolateAndLateral(const int& layer, const int& begin, const int& end); // Four cells at a time when usesAVX2().
+        void percolateAndLateralScalar(const int& layer, const int& begin, const int& end); // One cell at a time, for what's left over.
+        int percolateAndLateralAVX2(const int& layer, const int& begin, const int& end); // Returns the first cell it left to percolateAndLateralScalar().
+        void upwardsFlow(const int& layer, const int& begin, const int& end);
+        void moveWater(const int& layer, const int& begin, const int& end);
+
+        int cells, layers;
+    };
+}
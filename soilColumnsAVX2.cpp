@@ -0,0 +1,85 @@
+#include "soilColumns.h"
+#include "soil.h"
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using namespace ALMANAC;
+
+// The only file built with AVX2 code generation (/arch:AVX2), so none of it is called before SoilColumns::usesAVX2() has checked the CPU.
+
+#ifdef __AVX2__
+// exp() of four doubles at once, within a couple of ulps of std::exp.
+// Splits x into n * ln2 + r with |r| <= ln2 / 2, so e^x = 2^n * e^r, and e^r is a short Taylor series.
+static __m256d exp4(__m256d x)
+{
+    x = _mm256_min_pd(_mm256_max_pd(x, _mm256_set1_pd(-708.0)), _mm256_set1_pd(709.0));
+    __m256d n = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(1.4426950408889634)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256d r = _mm256_sub_pd(x, _mm256_mul_pd(n, _mm256_set1_pd(6.93147180369123816490e-01))); // ln2, split in two so r stays exact
+    r = _mm256_sub_pd(r, _mm256_mul_pd(n, _mm256_set1_pd(1.90821492927058770002e-10)));
+
+    __m256d p = _mm256_set1_pd(1.0 / 6227020800.0); // 1/13!
+    const double coefficients[] = { 1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0, 1.0 / 362880.0, 1.0 / 40320.0,
+        1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0, 1.0 / 24.0, 1.0 / 6.0, 1.0 / 2.0, 1.0, 1.0 };
+    for (double c : coefficients)
+        p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(c));
+
+    // 2^n, built straight into the exponent bits.
+    __m256i exponent = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n));
+    exponent = _mm256_slli_epi64(_mm256_add_epi64(exponent, _mm256_set1_epi64x(1023)), 52);
+    return _mm256_mul_pd(p, _mm256_castsi256_pd(exponent));
+}
+#endif
+
+bool SoilColumns::hasAVX2Kernel()
+{
+#ifdef __AVX2__
+    return true;
+#else
+    return false;
+#endif
+}
+
+// See SoilLayer::percolateAndLateral
+int SoilColumns::percolateAndLateralAVX2(const int& layer, const int& begin, const int& end)
+{
+    int cell = begin;
+#ifdef __AVX2__
+    const int offset = layer * cells;
+    // Four cells at a time. Cells below the threshold go through the same math and are masked to zero afterwards.
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d day = _mm256_set1_pd(24.0);
+    for (; cell + 4 <= end; cell += 4)
+    {
+        const int s = offset + cell;
+        __m256d w = _mm256_loadu_pd(&water[s]);
+        __m256d fc = _mm256_loadu_pd(&fieldCapacity[s]);
+        __m256d tt = _mm256_loadu_pd(&travelTime[s]);
+        __m256d excess = _mm256_sub_pd(w, fc);
+        __m256d percolating = _mm256_cmp_pd(w, _mm256_add_pd(fc, _mm256_set1_pd(0.000001f)), _CMP_GT_OQ);
+
+        __m256d lateralFlowTime = _mm256_div_pd(tt, _mm256_div_pd(_mm256_loadu_pd(&slope[cell]), _mm256_set1_pd(1000.0f)));
+        __m256d exponent = _mm256_sub_pd(_mm256_mul_pd(_mm256_sub_pd(zero, tt), day), _mm256_mul_pd(lateralFlowTime, day));
+        __m256d initialperc = _mm256_mul_pd(excess, _mm256_sub_pd(one, exp4(exponent)));
+        __m256d down = _mm256_div_pd(initialperc, _mm256_add_pd(one, _mm256_mul_pd(day, tt)));
+        __m256d lat = _mm256_div_pd(initialperc, _mm256_add_pd(one, _mm256_mul_pd(day, lateralFlowTime)));
+        down = _mm256_blendv_pd(zero, down, percolating);
+        lat = _mm256_blendv_pd(zero, lat, percolating);
+
+        _mm256_storeu_pd(&percolateDown[s], down);
+        _mm256_storeu_pd(&percolateUp[s], zero);
+        _mm256_storeu_pd(&lateral[s], lat);
+        _mm256_storeu_pd(&previousWater[s], _mm256_blendv_pd(zero, excess, _mm256_cmp_pd(excess, zero, _CMP_GT_OQ)));
+
+        __m256d n = _mm256_loadu_pd(&nitrates[s]);
+        __m256d capacity = _mm256_mul_pd(_mm256_loadu_pd(&saturatedMoisture[s]), _mm256_set1_pd(BL));
+        __m256d moved = _mm256_mul_pd(n, _mm256_sub_pd(one, exp4(_mm256_div_pd(_mm256_sub_pd(zero, _mm256_add_pd(down, lat)), capacity))));
+        _mm256_storeu_pd(&movedNitrates[s], moved);
+        _mm256_storeu_pd(&nitrates[s], _mm256_sub_pd(n, moved));
+    }
+#else
+    (void)layer; (void)end;
+#endif
+    return cell;
+}
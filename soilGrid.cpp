@@ -5,30 +5,20 @@
 #include <iostream>
 #include <cstdlib>
 #include "Weather.h"
+#include "forcing.h"
 #include "plantDictionary.h"
 #include <fstream>
+#include <algorithm>
+#include <cmath>
 
 using namespace ALMANAC;
 
 bool onlySand = false;
 
-void transferWater::transfer(SoilCell& waterOut, SoilCell& destination)
-{
-    if (waterOut.Layers.size() != destination.Layers.size())
-    {
-        std::cerr << "Layer sizes do not match.";
-        abort();
-    }
-    else
-    {
-        auto destit = destination.Layers.begin();
-        for (auto it = waterOut.Layers.begin(); it < waterOut.Layers.end(); it++)
-        {
-            destit->addWater(it->lateral);
-            destit++;
-        }
-    }
-}
+// Offsets to each neighbor, in the order of the enum {Moore}.
+const int mooreDX[8] = { 0, -1, -1, -1, 0, 1, 1, 1 };
+const int mooreDY[8] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+const int tileSize = 32; // Cells along each side of an activity tile.
 
 void SoilGrid::setPerlinProperties(noise::module::Perlin& gen, const double& freq, const double& lacturnity, const int& octave, const double&persist)
 {
@@ -72,7 +62,7 @@ int SoilGrid::random(int min, int max)
 }
 
 SoilGrid::SoilGrid(const int& w, const int& h, unsigned int seed)
-:width(w), height(h), test_numseeds(0), progress(0), test_iterations(0)
+: progress(0), test_numseeds(0), test_iterations(0), stride(w + 2), batchPlants(false), day(0), width(w), height(h)
 {
 
     maxprogress = w*h*2;
@@ -83,6 +73,7 @@ SoilGrid::SoilGrid(const int& w, const int& h, unsigned int seed)
         rand(); rand(); rand(); rand(); rand(); rand();
         seed = rand();
     }
+    worldSeed = seed;
     perlin.SetSeed(seed);
     sand.SetSeed(seed + 5); // Just random differences.
     clay.SetSeed(seed + 32);
@@ -101,11 +92,15 @@ SoilGrid::SoilGrid(const int& w, const int& h, unsigned int seed)
     SoilCell buffer;
     double baseheight, total;
 
-    const int layers = 10;
+    const int layers = maxSoilLayers;
 
 
     std::vector<soiltuple> soils(layers, soiltuple());
-    grid = std::vector<SoilCell>(width * height, SoilCell());
+    SoilCell halo;
+    halo.totalHeight = HUGE_VAL; // Never lower than a real cell, so no gradient or surface flow points into it.
+    halo.setMooreDirection(NONE);
+    halo.slope = 0;
+    grid = std::vector<SoilCell>(stride * (height + 2), halo);
     for (int y = 0; y < height; y++)
     for (int x = 0; x < width; x++)
     {
@@ -141,84 +136,169 @@ SoilGrid::SoilGrid(const int& w, const int& h, unsigned int seed)
             soils[counter] = stBuffer;
         }
 
-        grid[x + y * width] = SoilFactory::createCell(baseheight, 200, soils);
-        grid[x + y * width].surfaceWater = 0;
+        SoilCell& cell = grid[index(x, y)];
+        cell = SoilFactory::createCell(baseheight, 200, soils);
+        cell.surfaceWater = 0;
 
         if (baseheight < aquiferNumber)
-            grid[x + y * width].test_isUnderWater = true;
+            cell.test_isUnderWater = true;
         else
-            grid[x + y * width].test_isUnderWater = false;
+            cell.test_isUnderWater = false;
     }
 
     for (int y = 0; y < height; y++)
     for (int x = 0; x < width; x++)
     {
+        SoilCell& cell = grid[index(x, y)];
         vector3 vecbuffer = findGradientVector(x, y);
-        grid[x + y * width].setMooreDirection(findMooreDirection(vecbuffer));
-        grid[x + y * width].slope = vecbuffer.length;
+        cell.setMooreDirection(findMooreDirection(vecbuffer));
+        cell.slope = vecbuffer.length;
         if (vecbuffer.length != vecbuffer.length)
-            grid[x + y * width].slope = 0.0001f;
+            cell.slope = 0.0001f;
     }
+
+    findFlowNetwork();
+
+    // The halo gets slots as well so cells can be used as column indices directly. They are never attached or stepped.
+    columns.resize(grid.size(), layers);
+    for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+        columns.attach(grid[index(x, y)], index(x, y));
+
+    tilesWide = (width + tileSize - 1) / tileSize;
+    tilesHigh = (height + tileSize - 1) / tileSize;
+    seedCalendars.assign(tilesHigh, SeedCalendar());
+#ifndef STANDALONE
+    genomeBanks.assign(tilesHigh, HerbSim::GenomeBank());
+#endif
+    wakeAll();
 }
 
 void SoilGrid::initGridWithPlant(std::string plantID)
 {
-    ALMANAC::PlantProperties props = PD.getPlant(plantID);
+    // A plant in every cell that isn't sand, and a second one in about one in a hundred of them.
+    if (!populate(plantID, [this](const int& x, const int& y) { return get(x, y).getTopsoilGroup() != stgSANDGROUP ? 1.01 : 0.0; }, gen()))
+        return;
 
+#ifndef STANDALONE
+    // Seeds of one batch lying around, on one genome.
+    const int speciesID = PD.findSpeciesID(plantID);
+    std::vector<unsigned int> genomes(tilesHigh);
+    for (int row = 0; row < tilesHigh; row++)
+        genomes[row] = genomeBanks[row].add(PD.getPlant(speciesID), PD.getVisual(plantID));
     for (int xcounter = 0; xcounter < getWidth(); xcounter++)
     for (int ycounter = 0; ycounter < getHeight(); ycounter++)
     {
-        if (ref(xcounter, ycounter).getTopsoilGroup() != stgSANDGROUP)
-        {
-            if (rand() % 100 == 0)
-            {
-                BasePlant BP(props, PD.getVisual(plantID), &ref(xcounter, ycounter));
-                BP.vp.randomizeLerp();
-                ref(xcounter, ycounter).plants.push_back(BP);
-            }
+        if (random() < 0.1)
+            ref(xcounter, ycounter).addSeedItems(speciesID, genomes[ycounter / tileSize], 1);
+    }
+#endif
+}
 
+bool SoilGrid::populate(const std::string& species, const std::function<double(const int& x, const int& y)>& density, const unsigned int& seed)
+{
+    const int speciesID = PD.findSpeciesID(species);
+    if (speciesID < 0)
+    {
+        std::cerr << "Can't populate the map with " << species << ", it isn't in the plant dictionary. Skipped.\n";
+        return false;
+    }
+    const MasterPlantProperties& master = PD.getSpecies(speciesID);
+    const PlantVisualProperties visual = PD.getVisual(species);
 
-            BasePlant BP = BasePlant(props, PD.getVisual(plantID), &ref(xcounter, ycounter));
-            /*BP.height = 0.5;
-            BP.heatUnits = BP.prop.growthStages[10] / 10.0;*/
-            BP.vp.randomizeLerp();
-            ref(xcounter, ycounter).plants.push_back(BP);
-        }
+    pool.run(tilesHigh, [&](int job)
+    {
+        // The job's own generator for the genes. Copying MendelModule leaves rand() alone, unlike its constructors.
+        MendelianInheritance mendel(MendelModule);
+        mendel.seedGenerator(CounterRNG(seed, job).get(0, 0));
 
-        if (random() < 0.1)
+        const int firstRow = job * tileSize;
+        const int endRow = std::min(height, (job + 1) * tileSize);
+        for (int y = firstRow; y < endRow; y++)
         {
-            HerbSim::Seed seed = HerbSim::Seed(PD.getPlant(plantID), PD.getVisual(plantID));
-            if (ref(xcounter, ycounter).items.find(seed.prop.ID) == ref(xcounter, ycounter).items.end())
-                ref(xcounter, ycounter).items[seed.prop.ID] = HerbSim::MultiSeed(seed);
-            else
-                ref(xcounter, ycounter).items[seed.prop.ID].seeds.push_back(seed);
-        }
+            for (int x = 0; x < width; x++)
+            {
+                const double expected = density(x, y);
+                if (expected <= 0)
+                    continue;
+                int count = (int)expected;
+                if (CounterRNG(seed, index(x, y), 1).uniform(0, 0) < expected - count)
+                    count++;
+                if (count == 0)
+                    continue;
 
-    }
+                SoilCell& cell = grid[index(x, y)];
+                cell.plants.reserve(cell.plants.size() + count);
+                for (int counter = 0; counter < count; counter++)
+                {
+                    BasePlant plant(master.convert(mendel), visual, &cell);
+                    plant.vp.randomizeLerp(mendel);
+                    addPlant(index(x, y), plant);
+                }
+                tileAwake[tileOf(index(x, y))] = 1;
+            }
+        }
+    });
+    return true;
 }
 
-SoilCell SoilGrid::get(const int& x, const int& y)
+const SoilCell& SoilGrid::get(const int& x, const int& y) const
 {
-    if (x >= width || y >= height || x < 0 || y < 0)
-        return null;
-    else
-        return grid[x + y * width];
+    return grid[clampedIndex(x, y)];
 }
 
 SoilCell& SoilGrid::ref(const int& x, const int& y)
 {
-    if (x >= width || y >= height || x < 0 || y < 0)
-        return null;
-    else
-        return grid[x + y * width];
+    return grid[clampedIndex(x, y)];
+}
+
+int SoilGrid::clampedIndex(const int& x, const int& y) const
+{
+    if (inBounds(x, y))
+        return index(x, y);
+    int haloX = std::min(std::max(x, -1), width);
+    int haloY = std::min(std::max(y, -1), height);
+    return index(haloX, haloY);
 }
 
 void SoilGrid::set(const int& x, const int& y, const SoilCell& in)
 {
-    if (x >= width || y >= height || x < 0 || y < 0)
-        ;
-    else
-        grid[x + y * width] = in;
+    set(x, y, in, *this, x, y);
+}
+
+void SoilGrid::set(const int& x, const int& y, const SoilCell& in, const SoilGrid& from, const int& fromX, const int& fromY)
+{
+    if (inBounds(x, y))
+    {
+        grid[index(x, y)] = in;
+        seedCalendars[tileOf(index(x, y)) / tilesWide].clear(index(x, y)); // The new cell brings its own seeds.
+#ifndef STANDALONE
+        // Item genomes index the bank of the row they were dropped in, so they move over to this row's bank.
+        HerbSim::GenomeBank& bank = genomeBanks[tileOf(index(x, y)) / tilesWide];
+        if (!from.inBounds(fromX, fromY))
+            grid[index(x, y)].items.clear(); // Nowhere to look their genes up.
+        for (HerbSim::SeedItem& item : grid[index(x, y)].items)
+        {
+            const HerbSim::Seed& seed = from.getItemSeed(fromX, fromY, item); // Not invalidated by add(): same bank only when nothing is new.
+            item.genome = bank.add(seed.prop.pp, seed.prop.vp);
+        }
+#endif
+        columns.attach(grid[index(x, y)], index(x, y));
+        findFlowNetwork(); // The new cell brings its own Moore direction.
+        tileAwake[tileOf(index(x, y))] = 1;
+    }
+}
+
+bool SoilGrid::inBounds(const int& x, const int& y) const
+{
+    return x < width && y < height && x >= 0 && y >= 0;
+}
+
+bool SoilGrid::isHalo(const int& index) const
+{
+    int x = index % stride - 1;
+    int y = index / stride - 1;
+    return x < 0 || y < 0 || x >= width || y >= height;
 }
 
 int SoilGrid::getWidth()
@@ -235,22 +315,10 @@ vector3 SoilGrid::findMooreNeighborVector(const int& x, const int& y, const int&
 {
     SoilCell* copy;
     SoilCell* neighborCell;
-    copy = &ref(x, y);
-    int dX = 0, dY = 0; // deltaX, deltaY
-    if (neighbor == TOPLEFT || neighbor == LEFT || neighbor == BOTTOMLEFT)
-        dX -= 1;
-    else if (neighbor == BOTTOMRIGHT || neighbor == RIGHT || neighbor == TOPRIGHT)
-        dX += 1;
-    if (neighbor == TOP || neighbor == TOPLEFT || neighbor == TOPRIGHT)
-        dY -= 1;
-    else if (neighbor == BOTTOMLEFT || neighbor == BOTTOM || neighbor == BOTTOMRIGHT)
-        dY += 1;
-    neighborCell = &ref(x + dX, y + dY);
-    if (neighborCell == &null) // if out of bounds
-    {
-        return vector3(0, 0, 0);
-    }
-    //since it's not o.o.b, check if the other cell is taller than me.
+    copy = &grid[index(x, y)];
+    int dX = mooreDX[neighbor], dY = mooreDY[neighbor]; // deltaX, deltaY
+    neighborCell = &grid[index(x + dX, y + dY)];
+    // check if the other cell is taller than me. Halo cells always are.
     if (neighborCell->getTotalHeight() > copy->getTotalHeight())
         return vector3(0, 0, 0);
 
@@ -274,7 +342,7 @@ vector3 SoilGrid::findGradientVector(const int& x, const int& y)
             numberOfGradients++;
     }
     total /= (double)numberOfGradients;
-    ref(x, y).gradientVector = total;
+    grid[index(x, y)].gradientVector = total;
 
     return total;
 }
@@ -293,70 +361,280 @@ int SoilGrid::findMooreDirection(vector3 input)
     return neighborNumber % 8;
 }
 
-SoilCell* SoilGrid::findMooreNeighbor(const int& x, const int& y, const int& neighbor)
+void SoilGrid::findFlowNetwork()
 {
-    if (neighbor >= 0)
+    // The Moore directions don't change after construction, so neither flow pass needs to look them up every day.
+    downstream.assign(grid.size(), -1);
+    upstreamStart.assign(grid.size() + 1, 0);
+    for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
     {
-        int dX = 0, dY = 0; // deltaX, deltaY
-        if (neighbor == TOPLEFT || neighbor == LEFT || neighbor == BOTTOMLEFT)
-            dX -= 1;
-        else if (neighbor == BOTTOMRIGHT || neighbor == RIGHT || neighbor == TOPRIGHT)
-            dX += 1;
-        if (neighbor == TOP || neighbor == TOPLEFT || neighbor == TOPRIGHT)
-            dY -= 1;
-        else if (neighbor == BOTTOMLEFT || neighbor == BOTTOM || neighbor == BOTTOMRIGHT)
-            dY += 1;
+        int direction = grid[index(x, y)].getMooreDirection();
+        if (direction < 0)
+            continue; // Flat, drains nowhere.
+        int down = index(x + mooreDX[direction], y + mooreDY[direction]);
+        downstream[index(x, y)] = down;
+        if (!isHalo(down)) // Lateral water going into the halo leaves the map.
+            upstreamStart[down + 1]++;
+    }
 
-        return &ref(x + dX, y + dY);
+    for (int counter = 0; counter < grid.size(); counter++)
+        upstreamStart[counter + 1] += upstreamStart[counter];
+
+    // Filled in cell order, so every list is sorted and the sums always add up in the same order.
+    upstream.resize(upstreamStart.back());
+    std::vector<int> next(upstreamStart.begin(), upstreamStart.end() - 1);
+    for (int counter = 0; counter < grid.size(); counter++)
+    {
+        if (downstream[counter] != -1 && !isHalo(downstream[counter]))
+            upstream[next[downstream[counter]]++] = counter;
     }
-    return &null;
+
+    findFlowOrder();
 }
 
-void SoilGrid::doLateralForEachCell()
+void SoilGrid::findFlowOrder()
 {
+    // Every cell drains into at most one other, so the network is a forest and a cell can be placed
+    // as soon as everything upstream of it is. flowOrder doubles as the queue.
+    flowOrder.clear();
+    flowOrder.reserve(width * height);
+    std::vector<int> waiting(grid.size(), 0); // Upstream cells not placed yet.
     for (int y = 0; y < height; y++)
     for (int x = 0; x < width; x++)
     {
-        SoilCell* neighbor = findMooreNeighbor(x, y, grid[x + y * width].getMooreDirection());
-        if (neighbor == &null)
-            continue; // if equals null, skip.
-        else
-            transferWater::transfer(*neighbor, grid[x + y * width]);
+        int position = index(x, y);
+        waiting[position] = upstreamStart[position + 1] - upstreamStart[position];
+        if (waiting[position] == 0)
+            flowOrder.push_back(position);
+    }
+    for (int counter = 0; counter < flowOrder.size(); counter++)
+    {
+        int down = downstream[flowOrder[counter]];
+        if (down != -1 && !isHalo(down) && --waiting[down] == 0)
+            flowOrder.push_back(down);
+    }
+
+    // The Moore directions come from the local gradient, so a few cells can end up draining in a loop.
+    // Those never get placed above; put them at the end.
+    for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+    {
+        if (waiting[index(x, y)] > 0)
+            flowOrder.push_back(index(x, y));
+    }
+
+    flowAccumulation.assign(grid.size(), 1);
+    for (int counter = 0; counter < flowOrder.size(); counter++)
+    {
+        int down = downstream[flowOrder[counter]];
+        if (down != -1 && !isHalo(down))
+            flowAccumulation[down] += flowAccumulation[flowOrder[counter]];
+    }
+}
+
+void SoilGrid::routeRunoff()
+{
+    // In flow order, everything upstream of a cell has already arrived by the time it is visited,
+    // so one pass carries the water all the way down.
+    for (int counter = 0; counter < flowOrder.size(); counter++)
+    {
+        SoilCell& current = grid[flowOrder[counter]];
+        int down = downstream[flowOrder[counter]];
+        if (down == -1 || current.surfaceWater <= 0)
+            continue;
+        SoilCell& neighbor = grid[down];
+        if (neighbor.totalHeight >= current.totalHeight)
+            continue; // A pit, or the edge of the map. The water stays here.
+        neighbor.surfaceWater += current.surfaceWater;
+        current.surfaceWater = 0;
+        tileAwake[tileOf(down)] = 1;
+    }
+}
+
+int SoilGrid::getFlowAccumulation(const int& x, const int& y)
+{
+    if (inBounds(x, y))
+        return flowAccumulation[index(x, y)];
+    return 0;
+}
+
+void SoilGrid::doLateralForEachCell()
+{
+    // Lateral flow never goes further than the next cell, so only tiles next to an awake tile can receive any.
+    // Sleeping tiles always have their lateral outflow zeroed, so gathering from them adds nothing.
+    tileGathered.assign(tileAwake.size(), 0);
+    for (int tileY = 0; tileY < tilesHigh; tileY++)
+    for (int tileX = 0; tileX < tilesWide; tileX++)
+    {
+        if (!tileAwake[tileX + tileY * tilesWide])
+            continue;
+        for (int y = std::max(tileY - 1, 0); y <= std::min(tileY + 1, tilesHigh - 1); y++)
+        for (int x = std::max(tileX - 1, 0); x <= std::min(tileX + 1, tilesWide - 1); x++)
+            tileGathered[x + y * tilesWide] = 1;
+    }
+
+    // Every cell already put its outflow into columns.lateral, so each cell just collects from upstream.
+    int rows = rowsPerJob();
+    int jobs = (height + rows - 1) / rows;
+    pool.run(jobs, [&](int job)
+    {
+        int endRow = std::min(height, (job + 1) * rows);
+        for (int y = job * rows; y < endRow; y++)
+        {
+            int x = 0, spanEnd;
+            for (; nextSpan(tileGathered, y, x, spanEnd); x = spanEnd)
+                columns.gatherLateral(index(x, y), index(spanEnd, y), upstreamStart, upstream);
+        }
+    });
+
+    // Now that the water has settled for the day, see which tiles can sleep through the next one.
+    pool.run(tileGathered.size(), [&](int tile)
+    {
+        if (tileGathered[tile])
+            settleTile(tile);
+    });
+}
+
+void SoilGrid::settleTile(const int& tile)
+{
+    const int firstX = (tile % tilesWide) * tileSize;
+    const int firstY = (tile / tilesWide) * tileSize;
+    const int endX = std::min(width, firstX + tileSize);
+    const int endY = std::min(height, firstY + tileSize);
+
+    for (int y = firstY; y < endY; y++)
+    for (int x = firstX; x < endX; x++)
+    {
+        const SoilCell& cell = grid[index(x, y)];
+        if (cell.surfaceWater != 0 || cell.snow != 0 || !columns.isSettled(index(x, y)))
+        {
+            tileAwake[tile] = 1;
+            return;
+        }
+    }
+
+    // This tile's outflow was already gathered today. It will not be recomputed while the tile sleeps, so clear it.
+    if (tileAwake[tile])
+    {
+        for (int y = firstY; y < endY; y++)
+        for (int x = firstX; x < endX; x++)
+            columns.clearLateral(index(x, y));
     }
+    tileAwake[tile] = 0;
+}
+
+int SoilGrid::tileOf(const int& index) const
+{
+    int x = index % stride - 1;
+    int y = index / stride - 1;
+    return x / tileSize + (y / tileSize) * tilesWide;
+}
+
+bool SoilGrid::nextSpan(const std::vector<char>& tiles, const int& y, int& x, int& spanEnd) const
+{
+    if (x >= width)
+        return false;
+    const int row = (y / tileSize) * tilesWide;
+    int tile = x / tileSize;
+    while (tile < tilesWide && !tiles[row + tile])
+        tile++;
+    if (tile >= tilesWide)
+        return false;
+    x = std::max(x, tile * tileSize);
+    while (tile < tilesWide && tiles[row + tile])
+        tile++;
+    spanEnd = std::min(width, tile * tileSize);
+    return true;
+}
+
+void SoilGrid::wakeAll()
+{
+    tileAwake.assign(tilesWide * tilesHigh, 1);
 }
 
 void SoilGrid::stepAll(const WeatherData& wd)
 {
-    step(wd);
-    stepPlants(wd);
+    DailyForcing forcing(wd);
+    step(forcing);
+    stepPlants(forcing);
     test_iterations++;
 }
 
 void SoilGrid::step(const WeatherData& wd)
 {
-    double rainfall = wd.precipitation;
-    double temp = (wd.maxTemp + wd.minTemp) / 2.0;
-    
+    step(DailyForcing(wd));
+}
+
+void SoilGrid::step(const DailyForcing& forcing)
+{
+    double rainfall = forcing.weather.precipitation;
+
     progress = 0;
-    for (auto it = grid.begin(); it < grid.end(); it++)
+    if (rainfall > 0)
+        wakeAll(); // Rain reaches every cell.
+    // Up until the lateral flow no cell looks at any other cell, so the rows can be split up between threads.
+    // pool.run() only returns once all of them are done.
+    int rows = rowsPerJob();
+    int jobs = (height + rows - 1) / rows;
+    pool.run(jobs, [&](int job)
     {
-        progress++;
-        if (rainfall > 0)
-            it->addNitrogenToTop(0.0219 * rainfall);
-        if (temp < 0)
-            it->snow += rainfall;
-        else        
-            it->surfaceWater += rainfall;
-
-        it->doSnowmelt(temp);
-        it->solveAndPercolate();
-        it->calculateNitrogen(temp);
+        stepVertical(forcing, job * rows, std::min(height, (job + 1) * rows));
+    });
+    doLateralForEachCell();
+}
 
-        it->surfaceWater -= 3.675247456; // Using the max potential soil evaporation constant for now.
-        if (it->surfaceWater < 0)
-            it->surfaceWater = 0;
+void SoilGrid::stepVertical(const DailyForcing& forcing, const int& firstRow, const int& endRow)
+{
+    const double rainfall = forcing.weather.precipitation;
+    const double temp = forcing.averageTemp;
+    for (int y = firstRow; y < endRow; y++)
+    {
+        // Sleeping tiles are skipped. Without its two halo cells a row is one contiguous run of cells,
+        // so each run of awake tiles is too.
+        int x = 0, spanEnd;
+        for (; nextSpan(tileAwake, y, x, spanEnd); x = spanEnd)
+        {
+            const int begin = index(x, y);
+            const int end = index(spanEnd, y);
+            for (int position = begin; position < end; position++)
+            {
+                SoilCell& cell = grid[position];
+                if (rainfall > 0)
+                    columns.nitrates[columns.slot(position, 0)] += 0.0219 * rainfall;
+                if (temp < 0)
+                    cell.snow += rainfall;
+                else        
+                    cell.surfaceWater += rainfall;
+
+                cell.doSnowmelt(forcing.snowmeltFraction);
+                columns.infiltrate(position, cell.surfaceWater);
+                cell.calculateNitrogen(temp);
+
+                cell.surfaceWater -= 3.675247456; // Using the max potential soil evaporation constant for now.
+                if (cell.surfaceWater < 0)
+                    cell.surfaceWater = 0;
+            }
+            columns.solveAndPercolate(begin, end); // The layers only see the surface through infiltrate(), so this can run afterwards.
+        }
+        progress += width;
     }
-    doLateralForEachCell();
+}
+
+int SoilGrid::rowsPerJob()
+{
+    int rows = height / ((pool.size() + 1) * 4); // A few jobs per thread, so a slow one doesn't hold up the rest.
+    return rows > 0 ? rows : 1;
+}
+
+void SoilGrid::setWorkerCount(const int& workers)
+{
+    pool.resize(workers);
+}
+
+int SoilGrid::getWorkerCount()
+{
+    return pool.size();
 }
 
 void SoilGrid::stepSurfaceFlow(const WeatherData& wd, double timestep)
@@ -365,10 +643,10 @@ void SoilGrid::stepSurfaceFlow(const WeatherData& wd, double timestep)
     for (int x = 0; x < width; x++)
     for (int y = 0; y < height; y++)
     {
-        SoilCell* neighbor = findMooreNeighbor(x, y, grid[x + y * width].getMooreDirection());
-        SoilCell& current = ref(x, y);
-        if (neighbor == &null)
-            continue; // if equals null (ie, does not exist), skip.
+        if (downstream[index(x, y)] == -1)
+            continue; // Flat, skip. Cells draining into the halo are skipped below, the halo is always taller.
+        SoilCell& current = grid[index(x, y)];
+        SoilCell* neighbor = &grid[downstream[index(x, y)]];
         double myTotalHeight = current.getTotalHeight() + current.surfaceWater;
         double neighborTotalHeight = neighbor->getTotalHeight() + neighbor->surfaceWater;
         double diff = myTotalHeight - neighborTotalHeight;
@@ -396,7 +674,7 @@ void SoilGrid::stepSurfaceFlow(const WeatherData& wd, double timestep)
     for (int x = 0; x < width; x++)
     for (int y = 0; y < height; y++)
     {
-        SoilCell& current = ref(x, y);
+        SoilCell& current = grid[index(x, y)];
         double deltaW = current.flowInputs[0];
         current.flowInputs[0] = 0;
         for (int counter = 1; counter < 8; counter++)
@@ -405,138 +683,383 @@ void SoilGrid::stepSurfaceFlow(const WeatherData& wd, double timestep)
             current.flowInputs[counter] = 0;
         }
         current.surfaceWater += deltaW;
+        if (current.surfaceWater > 0)
+            tileAwake[tileOf(index(x, y))] = 1;
     }
 }
 
-void SoilGrid::stepPlants(const WeatherData& wd)
+int SoilGrid::routeSurfaceFlow(const WeatherData& wd, const double& duration, const int& maxSubsteps)
 {
-    test_totalrad = 0;
-    radPerPlant.clear();
-    for (auto it = grid.begin(); it < grid.end(); it++)
+    // Unlike stepSurfaceFlow, every substep first works out all the fluxes from the same state and only then
+    // moves the water, so rows can be handed to different threads and the order cells are visited in doesn't matter.
+    surfaceRate.assign(grid.size(), 0);
+    surfaceOutflow.assign(grid.size(), 0);
+    const int rows = rowsPerJob();
+    const int jobs = (height + rows - 1) / rows;
+    std::vector<double> jobLimit(jobs);
+    const double minimumStep = duration / maxSubsteps;
+
+    int substeps = 0;
+    double elapsed = 0;
+    while (elapsed < duration && substeps < maxSubsteps)
     {
-        double totalRad = wd.radiation; 
-        const double groundFraction = 1.0;
-        vector<double> intervals = { 0.0, 300, 600, 1000, 2000, 3000, 5000, 2000000 }; // does not simulate heights larger than 2 km
-        vector<double> rad(it->plants.size(), 0);
+        // How fast each cell drains into its downstream cell right now.
+        pool.run(jobs, [&](int job)
+        {
+            int endRow = std::min(height, (job + 1) * rows);
+            for (int y = job * rows; y < endRow; y++)
+            for (int position = index(0, y); position < index(width, y); position++)
+                surfaceRate[position] = std::min(surfaceDrop(position), grid[position].surfaceWater);
+        });
+
+        // Find the longest step after which no cell has risen above one that feeds it, or let go of more water than it has.
+        // Water moving into a cell raises it while the feeding cell drops, so the gap between them closes at
+        // the feeder's rate plus everything flowing into the cell.
+        pool.run(jobs, [&](int job)
+        {
+            double limit = HUGE_VAL;
+            int endRow = std::min(height, (job + 1) * rows);
+            for (int y = job * rows; y < endRow; y++)
+            for (int position = index(0, y); position < index(width, y); position++)
+            {
+                if (surfaceRate[position] > 0)
+                    limit = std::min(limit, grid[position].surfaceWater / surfaceRate[position]);
+
+                double inflow = 0;
+                for (int counter = upstreamStart[position]; counter < upstreamStart[position + 1]; counter++)
+                    inflow += surfaceRate[upstream[counter]];
+
+                for (int counter = upstreamStart[position]; counter < upstreamStart[position + 1]; counter++)
+                {
+                    int source = upstream[counter];
+                    if (surfaceRate[source] > 0)
+                        limit = std::min(limit, surfaceDrop(source) / (surfaceRate[source] + inflow));
+                }
+            }
+            jobLimit[job] = limit;
+        });
+
+        double step = duration - elapsed;
+        for (double limit : jobLimit)
+            step = std::min(step, limit);
+        step = std::max(step, std::min(minimumStep, duration - elapsed)); // Past maxSubsteps, stability gives way.
+        const bool last = step >= duration - elapsed;
 
-        for (int counter = intervals.size() - 1; counter >= 1; counter--)
+        // What each cell lets go of, which is never more than it has even when stability gave way, so no water is made.
+        pool.run(jobs, [&](int job)
         {
-            double consumedRad = 0;
-            double upperLimit = intervals[counter]; // Starts from the last element in intervals
-            double lowerLimit = intervals[counter - 1]; // Ends at 0.
-            double totalLAI = groundFraction;
-            if (counter == 1)
-                totalLAI = 0.01;
-            for (auto plant = it->plants.begin(); plant < it->plants.end(); plant++)
+            int endRow = std::min(height, (job + 1) * rows);
+            for (int y = job * rows; y < endRow; y++)
+            for (int position = index(0, y); position < index(width, y); position++)
+                surfaceOutflow[position] = std::min(step * surfaceRate[position], grid[position].surfaceWater);
+        });
+
+        pool.run(jobs, [&](int job)
+        {
+            int endRow = std::min(height, (job + 1) * rows);
+            for (int y = job * rows; y < endRow; y++)
+            for (int position = index(0, y); position < index(width, y); position++)
             {
-                if (plant->isDead())
-                    continue;
-                totalLAI += plant->getLAI() * plant->prop.LAIGraph.getPositiveArea(lowerLimit, upperLimit, plant->calcHeight()); // Add up the total LAI in the given interval 
+                double inflow = 0;
+                for (int counter = upstreamStart[position]; counter < upstreamStart[position + 1]; counter++)
+                    inflow += surfaceOutflow[upstream[counter]];
+                grid[position].surfaceWater += inflow - surfaceOutflow[position];
             }
-                
-            for (int counter = 0; counter < it->plants.size(); counter++)
+        });
+
+        elapsed = last ? duration : elapsed + step;
+        substeps++;
+    }
+
+    for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+    {
+        if (grid[index(x, y)].surfaceWater > 0)
+            tileAwake[tileOf(index(x, y))] = 1;
+    }
+    return substeps;
+}
+
+double SoilGrid::surfaceDrop(const int& index)
+{
+    if (downstream[index] == -1)
+        return 0; // Flat.
+    const SoilCell& current = grid[index];
+    const SoilCell& neighbor = grid[downstream[index]]; // Halo cells are infinitely tall, so nothing drains into them.
+    double drop = (current.totalHeight + current.surfaceWater) - (neighbor.totalHeight + neighbor.surfaceWater);
+    return drop > 0 ? drop : 0;
+}
+
+void SoilGrid::stepPlants(const WeatherData& wd)
+{
+    stepPlants(DailyForcing(wd));
+}
+
+void SoilGrid::stepPlants(const DailyForcing& forcing)
+{
+    // Each cell's plants only touch their own cell, so cells can run in any order and on any thread.
+    // Jobs are whole rows of tiles so no two of them wake the same tile. Anything shared is kept per row
+    // and merged afterwards in row order, which comes out the same whatever the thread count.
+    rowRadiation.assign(height, 0);
+    dormantDays.assign(PD.getSpeciesCount(), 0);
+    for (int speciesID = 0; speciesID < PD.getSpeciesCount(); speciesID++)
+    {
+        const SpeciesForcing* today = forcing.getSpecies(speciesID);
+        if (today)
+            dormantDays[speciesID] = BasePlant::findDormantDay(PD.getSpecies(speciesID), forcing.weather, *today);
+    }
+
+    pool.run(tilesHigh, [&](int job)
+    {
+        vector<double> rad;
+        const int firstRow = job * tileSize;
+        const int endRow = std::min(height, (job + 1) * tileSize);
+
+        // Seeds whose dormancy ends today go back to their cells.
+        vector<ParkedSeeds> due;
+        seedCalendars[job].takeDue(day, due);
+        for (const ParkedSeeds& parked : due)
+            grid[parked.index].seeds.push_back(parked.seeds);
+        if (!batchPlants)
+        {
+            for (int y = firstRow; y < endRow; y++)
             {
-                auto& plant = it->plants[counter];
-                // Give each plant its fraction of the radiation.
-                double deltaRad = totalRad * plant.getLAI() * plant.prop.LAIGraph.getPositiveArea(lowerLimit, upperLimit, plant.calcHeight()) / totalLAI;
-                rad[counter] += deltaRad;
-                consumedRad += deltaRad;
+                for (int x = 0; x < width; x++)
+                    stepCellPlants(index(x, y), forcing, rad, rowRadiation[y], 0);
+                progress += width;
             }
-            totalRad -= consumedRad; // Subtract the total taken rad and repeat.
+            return;
         }
 
-        for (double d : rad)
+        // The plants of the whole job are grown a species at a time, between the soil pass and the cleanup.
+        vector<PlantBatch> batches(PD.getSpeciesCount());
+        for (int y = firstRow; y < endRow; y++)
+            for (int x = 0; x < width; x++)
+                stepCellPlants(index(x, y), forcing, rad, rowRadiation[y], &batches);
+        for (PlantBatch& batch : batches)
+            batch.grow(forcing);
+        for (int y = firstRow; y < endRow; y++)
         {
-            test_totalrad += d;
+            for (int x = 0; x < width; x++)
+                finishCellPlants(index(x, y), forcing);
+            progress += width;
         }
+    });
 
-        int plantCounter = 0;
-        radPerPlant = rad;
-
-        if (ref(0, 0).plants.size() >= 1)
-            test_numseeds = ref(0, 0).plants[0].seedlist.size();
+    test_totalrad = 0;
+    for (double radiation : rowRadiation)
+        test_totalrad += radiation;
+    day++;
+}
 
+void SoilGrid::stepCellPlants(const int& index, const DailyForcing& forcing, vector<double>& rad, double& radiationSum, vector<PlantBatch>* batches)
+{
+    const WeatherData& wd = forcing.weather;
+    auto it = grid.begin() + index;
+    const bool lastCell = index == this->index(width - 1, height - 1); // The serial loop left the test_ values from this one.
+    CounterRNG rng = cellStream(index);
+    unsigned int draw = 0;
+    canopy.shareLight(it->plants, wd.radiation, rad);
+
+    for (double d : rad)
+    {
+        radiationSum += d;
+    }
 
-        double tolerence = 0.00001; // 0.01 g
+    if (lastCell)
+    {
+        radPerPlant = rad;
+        test_numseeds = getSeedCount(width - 1, height - 1);
+    }
 
-        test_numseeds = it->seeds.size();
-        for (auto plant = it->plants.begin(); plant < it->plants.end(); plant++)
+    for (auto plant = it->plants.begin(); plant < it->plants.end(); plant++)
+    {
+        const double radPortion = rad[plant - it->plants.begin()]; // Canopy::shareLight() gives each plant its own share.
+        if (plant->sleepEnd > day)
         {
-            double radPortion = rad[plantCounter];
-            plant->calculate(wd, 0.25, radPortion);
+            // Asleep. Its seeds and dead matter were collected before it fell asleep, and it makes none.
+            plant->passDormantDay(dormantDays[plant->species().speciesID]);
+            continue;
+        }
+        if (!batches)
+            plant->calculate(forcing, 0.25, radPortion);
+        else
+        {
+            // Same as calculate(), with grow() left to the plant's batch. Plants from outside the dictionary have none.
+            const SpeciesForcing today = plant->getSpeciesForcing(forcing);
+            if (plant->startDay(forcing, today))
+            {
+                plant->takeFromSoil(forcing);
+                const int speciesID = plant->species().speciesID;
+                if (speciesID >= 0 && speciesID < (int)batches->size())
+                    (*batches)[speciesID].add(*plant, radPortion);
+                else
+                    plant->grow(forcing, today, radPortion);
+            }
+        }
 
 
-            // Collect seeds
-            if (plant->seedlist.size() > 0)
+        // Collect seeds
+        if (plant->seedlist.size() > 0)
+        {
+            SeedCohort* cohort = 0; // Found once the first seed survives, so a plant with no viable seeds adds no cohort.
+            int itemSeeds = 0;
+            for (double s : plant->seedlist)
             {
-                
-                for (Seed s : plant->seedlist)
+                double chance = rng.uniform(day, draw++);
+                if (plant->species().seedViability > chance) // Unlucky seeds are simply removed for now. TODO: Tie into item spawning system and spawn as items.
+                {
+                    if (!cohort)
+                        cohort = &it->findSeedCohort(plant->prop, plant->vp, wd.date);
+                    cohort->addSeed(s);
+                }
+                else
                 {
-                    double chance = random();
-                    if (s.pp.seedViability > chance) // Unlucky seeds are simply removed for now. TODO: Tie into item spawning system and spawn as items.
-                        it->seeds.push_back(s);
-                    else
-                    {
 #ifndef STANDALONE
-                        chance = random();
-                        if (chance < 0.5) // half the seeds are put into the item list.
-                        {
-                            HerbSim::Seed seed = HerbSim::Seed(s.pp, s.vp);
-                            if (it->items.find(seed.prop.ID) == it->items.end())
-                                it->items[seed.prop.ID] = HerbSim::MultiSeed(seed);
-                            else
-                                it->items[seed.prop.ID].seeds.push_back(seed);                        
-                        }
-                        
+                    chance = rng.uniform(day, draw++);
+                    if (chance < 0.5) // half the seeds are put into the item list.
+                        itemSeeds++;
 #endif
-                    }
                 }
-                plant->seedlist.clear();
             }
+#ifndef STANDALONE
+            if (itemSeeds > 0) // All of a plant's seeds have its genes, so they go on one pile.
+                it->addSeedItems(plant->species().speciesID, genomeBanks[tileOf(index) / tilesWide].add(plant->prop, plant->vp), itemSeeds);
+#endif
+            plant->seedlist.clear();
+        }
 
-            // Collect dead matter.
-            if (plant->deadBiomass > 0)
-            {
-                it->Layers.front().nitrates += plant->removedNitrogen;
-                it->Layers.front().plantmatter += plant->deadBiomass;
+        // Collect dead matter.
+        if (plant->deadBiomass > 0)
+        {
+            it->Layers.front().addNitrates(plant->removedNitrogen);
+            it->Layers.front().plantmatter += plant->deadBiomass;
 
-                plant->deadBiomass = plant->removedNitrogen = 0;
-            }
+            plant->deadBiomass = plant->removedNitrogen = 0;
         }
+    }
+
+    if (!batches)
+        finishCellPlants(index, forcing);
+}
+
+void SoilGrid::finishCellPlants(const int& index, const DailyForcing& forcing)
+{
+    const WeatherData& wd = forcing.weather;
+    auto it = grid.begin() + index;
+    double tolerence = 0.00001; // 0.01 g
 
-        vector<BasePlant>& plantlist = it->plants;
-        for (int counter = 0; counter < plantlist.size(); counter++)
+    vector<BasePlant>& plantlist = it->plants;
+    for (int counter = 0; counter < plantlist.size(); counter++)
+    {
+        BasePlant& plant = plantlist[counter];
+        if (plant.isDead() && plant.getBiomass() < tolerence)
         {
-            BasePlant& plant = plantlist[counter];
-            if (plant.isDead() && plant.getBiomass() < tolerence)
-            {
-                plantlist[counter] = plantlist.back();
-                plantlist.pop_back(); // Overwrite this plant with the plant at the back of vector, and remove the final element, effectively removing a plant from the list.
-            }
+            plantlist[counter] = plantlist.back();
+            plantlist.pop_back(); // Overwrite this plant with the plant at the back of vector, and remove the final element, effectively removing a plant from the list.
         }
+    }
 
+    // Perennials left waiting out their heat unit reset run just passDormantDay() until it comes. Done once the day's growth is in.
+    for (BasePlant& plant : plantlist)
+    {
+        if (plant.sleepEnd <= day)
+            sleepPlant(plant);
+    }
 
-        // Run seeds.
-        for (Seed& seed : it->seeds)
+
+    // Seeds still in their dormancy are put away until the day it ends, and cost nothing until then.
+    for (int counter = 0; counter < it->seeds.size(); counter++)
+    {
+        const int daysLeft = it->seeds[counter].getDormantDaysLeft(wd.date);
+        if (daysLeft > 0)
         {
-            if (seed.attemptGerminate(wd))
-                it->plants.push_back(BasePlant(seed, &(*it)));
+            seedCalendars[tileOf(index) / tilesWide].park(index, it->seeds[counter], day + daysLeft);
+            it->seeds[counter] = it->seeds.back();
+            it->seeds.pop_back();
+            counter--;
         }
+    }
 
-        for (int counter = 0; counter < it->seeds.size(); counter++)
+    // Run seeds. A whole cohort germinates on the same day.
+    for (SeedCohort& cohort : it->seeds)
+    {
+        if (cohort.attemptGerminate(wd))
         {
-            if (it->seeds.at(counter).germinated)
-            {
-                it->seeds[counter] = it->seeds.back();
-                it->seeds.pop_back();
-                counter--;
-            }
+            const BasePlant seedling(cohort, &(*it));
+            for (int counter = 0; counter < cohort.count; counter++)
+                addPlant(index, seedling);
         }
-        
-        plantCounter++;
-        progress++;
     }
 
+    for (int counter = 0; counter < it->seeds.size(); counter++)
+    {
+        if (it->seeds.at(counter).germinated)
+        {
+            it->seeds[counter] = it->seeds.back();
+            it->seeds.pop_back();
+            counter--;
+        }
+    }
+    
+    if (!it->plants.empty())
+        tileAwake[tileOf(index)] = 1; // Plants take water and nitrogen out of the soil.
+}
+
+void SoilGrid::addPlant(const int& index, const BasePlant& plant)
+{
+    SoilCell& cell = grid[index];
+    cell.plants.push_back(plant);
+    cell.plants.back().rng = CounterRNG(worldSeed, index, ++cell.plantsStarted); // Serials start at 1, 0 is cellStream().
+}
+
+void SoilGrid::sleepPlant(BasePlant& plant)
+{
+    const int speciesID = plant.species().speciesID;
+    if (speciesID < 0 || speciesID >= PD.getSpeciesCount())
+        return; // Only dictionary species have their days in dormantDays.
+    const int days = plant.findSleepDays();
+    if (days > 0)
+        plant.sleepEnd = day + 1 + days;
+}
+
+void SoilGrid::setBatchedPlants(const bool& batched)
+{
+    batchPlants = batched;
+}
+
+Canopy& SoilGrid::getCanopy()
+{
+    return canopy;
+}
+
+int SoilGrid::getSeedCount(const int& x, const int& y)
+{
+    if (!inBounds(x, y))
+        return 0;
+    const int cell = index(x, y);
+    return grid[cell].getSeedCount() + seedCalendars[tileOf(cell) / tilesWide].getSeedCount(cell);
+}
+
+void SoilGrid::clearSeeds(const int& x, const int& y)
+{
+    if (!inBounds(x, y))
+        return;
+    const int cell = index(x, y);
+    grid[cell].seeds.clear();
+    seedCalendars[tileOf(cell) / tilesWide].clear(cell);
+}
+
+#ifndef STANDALONE
+const HerbSim::Seed& SoilGrid::getItemSeed(const int& x, const int& y, const HerbSim::SeedItem& item) const
+{
+    return genomeBanks[tileOf(index(x, y)) / tilesWide].get(item.genome);
+}
+#endif
+
+CounterRNG SoilGrid::cellStream(const int& index)
+{
+    return CounterRNG(worldSeed, index, 0);
 }
 
 void SoilGrid::addRandomWater(const int& numberOf, const int& howMuch)
@@ -545,11 +1068,18 @@ void SoilGrid::addRandomWater(const int& numberOf, const int& howMuch)
     {
         ref(random(0, width - 1), random(0, height - 1)).getFront().addWater(howMuch);
     }
+    wakeAll();
 }
 
 void SoilGrid::addWaterSquare(const int& x, const int& y, const int& w, const int& h, const double& howMuch)
 {
     for (int yC = y; yC < y + h; yC++)
     for (int xC = x; xC < x + w; xC++)
-        ref(xC, yC).getFront().addWater(howMuch);
+    {
+        if (inBounds(xC, yC))
+        {
+            ref(xC, yC).getFront().addWater(howMuch);
+            tileAwake[tileOf(index(xC, yC))] = 1;
+        }
+    }
 }
\ No newline at end of file
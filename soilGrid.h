@@ -3,7 +3,14 @@
 #include <vector>
 #include "vector3.h"
 #include <random>
+#include <atomic>
+#include <functional>
 #include "noise.h"
+#include "threadPool.h"
+#include "counterRng.h"
+#include "canopy.h"
+#include "plantBatch.h"
+#include "seedCalendar.h"
 #include "config.h"
 #ifndef STANDALONE
 #include "item.h"
@@ -13,15 +20,24 @@
 namespace ALMANAC
 {
     struct  WeatherData;
+    struct DailyForcing;
 
     class SoilGrid // All of the soil stuffs :v
     {
     public:
         SoilGrid(const int& w, const int& h, unsigned int seed = 0);
         void initGridWithPlant(std::string plantID);
-        SoilCell get(const int& x, const int& y);
-        SoilCell& ref(const int& x, const int& y);
-        void set(const int& x, const int& y, const SoilCell& in);
+        // Plants the species all over the map, a row of tiles per job. density(x, y) is how many plants the cell gets
+        // on average: the whole part for sure, and one more with the chance of what's left. It's called from the
+        // worker threads. Every plant gets its own genes, drawn per job, so the same seed gives the same plants
+        // whatever the thread count. Returns false, having planted nothing, if the species isn't in the plant dictionary.
+        bool populate(const std::string& species, const std::function<double(const int& x, const int& y)>& density, const unsigned int& seed);
+        const SoilCell& get(const int& x, const int& y) const; // Same cell as ref(), read only.
+        SoilCell& ref(const int& x, const int& y); // Off-map coordinates give the nearest halo cell, which has no layers.
+        void set(const int& x, const int& y, const SoilCell& in); // in is cell (x, y) of this grid, as got from get() and then changed.
+        // in is cell (fromX, fromY) of from. Its seed items' genes are looked up there, as they aren't kept in the cell.
+        void set(const int& x, const int& y, const SoilCell& in, const SoilGrid& from, const int& fromX, const int& fromY);
+        bool inBounds(const int& x, const int& y) const;
 
         int getWidth();
         int getHeight();
@@ -29,12 +45,32 @@ namespace ALMANAC
         void stepAll(const WeatherData& wd); // Advances soil water sim AND plant sim, but NOT surface flow sim.
         void step(const WeatherData& wd); // Advance water simulation by one day
         void stepSurfaceFlow(const WeatherData& wd, double timestep = 1); // advance surface flow by one day
+        // Advances surface flow by duration days, in as many substeps as it takes to stay stable, up to maxSubsteps.
+        // Returns the number of substeps used.
+        int routeSurfaceFlow(const WeatherData& wd, const double& duration = 1, const int& maxSubsteps = 100);
+        void routeRunoff(); // Moves all surface water downhill along the Moore directions until it reaches a pit or the edge, in one pass.
+        int getFlowAccumulation(const int& x, const int& y); // How many cells, itself included, drain through this cell.
         void stepPlants(const WeatherData& wd);
+        // Same as step() and stepPlants(), with the day's shared values already worked out. stepAll() uses these.
+        void step(const DailyForcing& forcing);
+        void stepPlants(const DailyForcing& forcing);
 
         void addRandomWater(const int& numberOf, const int& howMuch); // for testing
         void addWaterSquare(const int& x, const int& y, const int& w, const int& h, const double& howMuch);
 
-        int progress;
+        void setWorkerCount(const int& workers); // Extra threads used by step() and stepPlants(). 0 runs everything on the calling thread.
+        int getWorkerCount();
+        // Grows plants a species at a time with PlantBatch rather than one by one. Results match to within rounding.
+        void setBatchedPlants(const bool& batched);
+        Canopy& getCanopy(); // How stepPlants() shares out light. Its layers can be changed between steps.
+        void wakeAll(); // step() skips cells it thinks are at rest. Call this after changing cells through ref().
+        int getSeedCount(const int& x, const int& y); // All of a cell's seeds, dormant ones included.
+        void clearSeeds(const int& x, const int& y); // Removes all of a cell's seeds, dormant ones included.
+#ifndef STANDALONE
+        const HerbSim::Seed& getItemSeed(const int& x, const int& y, const HerbSim::SeedItem& item) const; // Genes and looks of one of the cell's items.
+#endif
+
+        std::atomic<int> progress;
         int maxprogress;
 
         double test_totalrad;
@@ -42,13 +78,41 @@ namespace ALMANAC
         int test_iterations;
 
         std::vector<double> radPerPlant;
-        SoilCell null;
 
     private:
         double random(double min = 0.0, double max = 1.0);
         int random(int min, int max);
+        // grid has a one cell wide halo around the map, so neighbor lookups never leave the vector.
+        // Halo cells are infinitely tall and have no layers, so nothing ever flows into them.
         std::vector<SoilCell> grid;
-        std::mt19937 gen;
+        int stride; // width + 2, the length of a row of grid.
+        int index(const int& x, const int& y) const { return (x + 1) + (y + 1) * stride; }
+        bool isHalo(const int& index) const;
+        int clampedIndex(const int& x, const int& y) const; // Off-map coordinates give the nearest halo cell.
+        SoilColumns columns; // Water and nitrates of every layer in grid, layer by layer.
+        ThreadPool pool;
+        std::vector<int> downstream; // The cell each cell drains into, which may be a halo cell, or -1 if it is flat.
+        std::vector<int> upstreamStart, upstream; // The cells draining into cell i are upstream[upstreamStart[i]] .. upstream[upstreamStart[i + 1] - 1].
+        std::vector<int> flowOrder; // Every cell on the map, each one after all of the cells upstream of it.
+        std::vector<int> flowAccumulation;
+        // The map is split into square tiles. A tile sleeps while none of its cells can change in step(),
+        // and is woken by rain, surface water, plants, or lateral flow from a neighboring tile.
+        // Flags are chars rather than a vector<bool> so different threads can write neighboring tiles.
+        int tilesWide, tilesHigh;
+        std::vector<char> tileAwake;
+        std::vector<char> tileGathered; // Tiles doLateralForEachCell() has to look at: the awake ones and their neighbors.
+        std::vector<double> surfaceRate, surfaceOutflow; // For routeSurfaceFlow(): how fast each cell drains per day, and what it lets go of this substep.
+        Canopy canopy;
+        bool batchPlants;
+        std::vector<double> rowRadiation; // Light taken by the plants in each row, added up after stepPlants() runs.
+        std::vector<char> dormantDays; // BasePlant::findDormantDay() of each species today, for the plants sleeping through their dormancy.
+        std::vector<SeedCalendar> seedCalendars; // Seeds in their dormancy. One per row of tiles, so each stepPlants() job has its own.
+#ifndef STANDALONE
+        std::vector<HerbSim::GenomeBank> genomeBanks; // Genes of the seed items, one per row of tiles like seedCalendars.
+#endif
+        std::mt19937 gen; // For setting up the map. Draws made while stepping use counter-based streams instead.
+        unsigned int worldSeed;
+        unsigned int day; // How many times stepPlants() has run. Per-cell draws are keyed by it.
         int width, height;
         noise::module::Perlin perlin;
         noise::module::Perlin sand, clay, silt;
@@ -57,10 +121,24 @@ namespace ALMANAC
 
         vector3 findGradientVector(const int& x, const int& y);
         vector3 findMooreNeighborVector(const int& x, const int& y, const int& neighbor); // @ Returns 0 if not applicable.
-        SoilCell* findMooreNeighbor(const int& x, const int& y, const int& neighbor);
         void setPerlinProperties(noise::module::Perlin& gen, const double& freq, const double& lacturnity, const int& octave, const double&persist);
         int findMooreDirection(vector3 input);
+        void stepVertical(const DailyForcing& forcing, const int& firstRow, const int& endRow); // Everything in step() that stays inside a cell, for rows [firstRow, endRow).
+        int rowsPerJob(); // How many rows of the grid one pool job takes on.
+        void findFlowNetwork(); // Fills downstream, upstreamStart and upstream from the Moore directions.
+        void findFlowOrder(); // Fills flowOrder and flowAccumulation from the network.
         void doLateralForEachCell(); // Move lateral flow stuff thingies.
+        // stepPlants() for one cell. rad is scratch. With batches, plants that grow today are added to their species' batch,
+        // and finishCellPlants() has to be called once the batches have grown.
+        void stepCellPlants(const int& index, const DailyForcing& forcing, std::vector<double>& rad, double& radiationSum, std::vector<PlantBatch>* batches);
+        void finishCellPlants(const int& index, const DailyForcing& forcing); // Removes dead plants and germinates seeds.
+        void addPlant(const int& index, const BasePlant& plant); // Gives the plant its own random stream.
+        void sleepPlant(BasePlant& plant); // Cuts short the days BasePlant::findSleepDays() allows, if any.
+        CounterRNG cellStream(const int& index); // For the cell's own draws, eg. which seeds survive.
+        int tileOf(const int& index) const;
+        bool nextSpan(const std::vector<char>& tiles, const int& y, int& x, int& spanEnd) const; // Finds the next run of flagged tiles on row y, starting at x.
+        void settleTile(const int& tile); // Puts the tile to sleep if all of its cells are at rest, wakes it otherwise.
+        double surfaceDrop(const int& index); // How far the water surface of a cell is above that of its downstream cell, or 0.
         void doRunoff(); // Move water, and let some of it be absorbed
     };
 }
\ No newline at end of file
@@ -1,18 +1,19 @@
 #include "soilModel.h"
 #include <iostream>
 #include <cmath>
+#include <cstdlib>
 
 using namespace ALMANAC;
 using namespace ALMANAC::SOIL_MODELS;
 
-SoilProperties SoilModule::setState(const double& sand, const double& silt, const double& clay, const double& organicMatter)
+SoilProperties SoilModule::setState(const double& sand, const double& /*silt*/, const double& clay, const double& organicMatter)
 {
     internalBuffer = SoilModule1.setState(sand, clay, organicMatter);
     internalBuffer.travelTime = (internalBuffer.saturatedMoisture - internalBuffer.fieldCapacity) / internalBuffer.SatHydConductivity;
     return internalBuffer;
 }
 
-SoilProperties SoilModule::fetch(const double& sand, const double& silt, const double& clay, const double& organicMatter)
+SoilProperties SoilModule::fetch(const double& sand, const double& /*silt*/, const double& clay, const double& organicMatter)
 {
     Saxton2006 SoilModuleA;
     SoilProperties internalBuffer = SoilModuleA.setState(sand, clay, organicMatter);
@@ -20,6 +21,53 @@ SoilProperties SoilModule::fetch(const double& sand, const double& silt, const d
     return internalBuffer;
 }
 
+std::vector<SoilProperties> SoilPropertyTable::table;
+std::unordered_map<long long, int> SoilPropertyTable::lookup;
+double SoilPropertyTable::resolution = 0.01;
+
+int SoilPropertyTable::find(const double& sand, const double& silt, const double& clay, const double& organicMatter)
+{
+    // Saxton2006 does not use silt, so neither does the key.
+    long long steps[3] = { std::llround(sand / resolution), std::llround(clay / resolution), std::llround(organicMatter / resolution) };
+    const long long mask = (1 << 21) - 1;
+    long long key = ((steps[0] & mask) << 42) | ((steps[1] & mask) << 21) | (steps[2] & mask);
+
+    auto it = lookup.find(key);
+    if (it != lookup.end())
+        return it->second;
+
+    table.push_back(SoilModule::fetch(steps[0] * resolution, silt, steps[1] * resolution, steps[2] * resolution));
+    lookup[key] = table.size() - 1;
+    return table.size() - 1;
+}
+
+const SoilProperties& SoilPropertyTable::get(const int& index)
+{
+    return table[index];
+}
+
+void SoilPropertyTable::setResolution(const double& newResolution)
+{
+    if (newResolution <= 0 || 1 / newResolution >= (1 << 21))
+    {
+        std::cerr << "Soil property resolution " << newResolution << " is out of range.";
+        abort();
+    }
+    resolution = newResolution;
+    table.clear();
+    lookup.clear();
+}
+
+double SoilPropertyTable::getResolution()
+{
+    return resolution;
+}
+
+int SoilPropertyTable::size()
+{
+    return table.size();
+}
+
 SoilProperties SoilModule::getState()
 {
     return internalBuffer;
@@ -1,4 +1,6 @@
 #pragma once
+#include <vector>
+#include <unordered_map>
 
 namespace ALMANAC
 {
@@ -38,5 +40,22 @@ namespace ALMANAC
             Saxton2006 SoilModule1;
             SoilProperties internalBuffer;
         };
+
+        /// A shared, memoized table of SoilProperties. Textures are rounded to the resolution before they are looked up,
+        /// so layers with nearly the same texture share one entry, and each layer only has to keep the index.
+        /// Not thread safe; soil layers are only made on one thread.
+        class SoilPropertyTable
+        {
+        public:
+            static int find(const double& sand, const double& silt, const double& clay, const double& organicMatter);
+            static const SoilProperties& get(const int& index);
+            static void setResolution(const double& resolution); // Fraction of texture per step, 0.01 by default. Clears the table, so only change this before any layers exist.
+            static double getResolution();
+            static int size();
+        private:
+            static std::vector<SoilProperties> table;
+            static std::unordered_map<long long, int> lookup;
+            static double resolution;
+        };
     }
 }
\ No newline at end of file
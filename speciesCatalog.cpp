@@ -0,0 +1,292 @@
+#include "speciesCatalog.h"
+#include "mappedFile.h"
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+
+using namespace ALMANAC;
+
+namespace
+{
+    const char catalogMagic[4] = { 'A', 'L', 'M', 'C' };
+
+    // Appends fields to a buffer in the machine's own layout. The catalog is a cache made where it is used.
+    class CatalogWriter
+    {
+    public:
+        template <class T> void raw(const T& value)
+        {
+            buffer.append((const char*)&value, sizeof(T));
+        }
+        void value(double& v) { raw(v); }
+        void value(int& v) { raw(v); }
+        void value(unsigned int& v) { raw(v); }
+        void value(bool& v) { raw((char)v); }
+        void value(std::string& v)
+        {
+            raw((unsigned int)v.size());
+            buffer.append(v);
+        }
+        void value(std::map<int, double>& v)
+        {
+            raw((unsigned int)v.size());
+            for (auto& entry : v)
+            {
+                raw(entry.first);
+                raw(entry.second);
+            }
+        }
+        std::string buffer;
+    };
+
+    // Takes fields back out of the mapped file, in the order the writer put them. Once a read would run past the
+    // end, ok turns false and every read after it does nothing.
+    class CatalogReader
+    {
+    public:
+        CatalogReader(const char* data, const size_t& size)
+        : next(data), end(data + size), ok(true)
+        {
+        }
+        template <class T> void raw(T& value)
+        {
+            if (!ok || (size_t)(end - next) < sizeof(T))
+            {
+                ok = false;
+                return;
+            }
+            memcpy(&value, next, sizeof(T));
+            next += sizeof(T);
+        }
+        void value(double& v) { raw(v); }
+        void value(int& v) { raw(v); }
+        void value(unsigned int& v) { raw(v); }
+        void value(bool& v)
+        {
+            char stored = 0;
+            raw(stored);
+            v = stored != 0;
+        }
+        void value(std::string& v)
+        {
+            unsigned int length = 0;
+            raw(length);
+            if (!ok || (size_t)(end - next) < length)
+            {
+                ok = false;
+                return;
+            }
+            v.assign(next, length);
+            next += length;
+        }
+        void value(std::map<int, double>& v)
+        {
+            unsigned int count = 0;
+            raw(count);
+            v.clear();
+            for (unsigned int counter = 0; counter < count && ok; counter++)
+            {
+                int key = 0;
+                double stage = 0;
+                raw(key);
+                raw(stage);
+                v[key] = stage;
+            }
+        }
+        const char* next;
+        const char* end;
+        bool ok;
+    };
+
+    // The fields of each type, listed once for both the writer and the reader.
+    template <class Archive, class T> void describe(Archive& ar, std::pair<T, T>& v)
+    {
+        ar.value(v.first);
+        ar.value(v.second);
+    }
+    template <class Archive> void describe(Archive& ar, Parabola& v)
+    {
+        ar.value(v.width);
+        ar.value(v.parallel);
+        ar.value(v.vertical);
+    }
+    template <class Archive> void describe(Archive& ar, LeafDistribution& v)
+    {
+        ar.value(v.p);
+        ar.value(v.a);
+        ar.value(v.b);
+        ar.value(v.c);
+        ar.value(v.leftRoot);
+        ar.value(v.rightRoot);
+    }
+    template <class Archive> void describe(Archive& ar, SCurve& v)
+    {
+        ar.value(v.scale);
+        ar.value(v.horiz);
+        ar.value(v.vert);
+        ar.value(v.up);
+    }
+    template <class Archive> void describe(Archive& ar, BiomassHolder& v)
+    {
+        ar.value(v.stem);
+        ar.value(v.roots);
+        ar.value(v.storageOrgan);
+        ar.value(v.flowerAndfruits);
+    }
+    template <class Archive> void describe(Archive& ar, RGB& v)
+    {
+        ar.value(v.r);
+        ar.value(v.g);
+        ar.value(v.b);
+    }
+
+    template <class Archive> void describe(Archive& ar, MasterPlantProperties& pp)
+    {
+        ar.value(pp.name);
+        ar.value(pp.growthStages);
+        ar.value(pp.baseTemp);
+        describe(ar, pp.HeatUnitFactorNums);
+        describe(ar, pp.CO2CurveFactors);
+        describe(ar, pp.flowerTempCurve);
+        describe(ar, pp.tempCurve);
+        describe(ar, pp.vernalizationCurve);
+        describe(ar, pp.LAIGraph);
+        describe(ar, pp.nightLengthCurve);
+
+        ar.value(pp.startingNitrogenConcentration);
+        ar.value(pp.finalNitrogenConcentration);
+        describe(ar, pp.baseRatios);
+        describe(ar, pp.fruitingRatios);
+        describe(ar, pp.finalRatios);
+
+        ar.value(pp.dormantHeightDecrease);
+        ar.value(pp.dormantRootDecrease);
+        describe(ar, pp.dormantBiomassDecrease);
+        ar.value(pp.minimumTemperature);
+        ar.value(pp.optimalTemperature);
+
+        ar.value(pp.minGerminationTemp);
+        ar.value(pp.optimalGerminationTemp);
+        ar.value(pp.germinationThermalUnits);
+        ar.value(pp.seedViability);
+        ar.value(pp.dormancy);
+
+        ar.value(pp.minFloweringTemp);
+        ar.value(pp.optimalFloweringTemp);
+        ar.value(pp.minVernalizationTemp);
+        ar.value(pp.optimalVernalizationTemp);
+        ar.value(pp.vernalizationThermalUnits);
+        ar.value(pp.needsVernalization);
+        ar.value(pp.isObligateVernalization);
+
+        ar.value(pp.floralInductionUnitsRequired);
+        ar.value(pp.dayNeutral);
+        ar.value(pp.longDayPlant);
+        ar.value(pp.minimumInduction);
+        ar.value(pp.criticalNightLength);
+        ar.value(pp.biomassToVPD);
+        ar.value(pp.isAnnual);
+        ar.value(pp.isTree);
+
+        describe(ar, pp.maxLAI_r);
+        describe(ar, pp.waterTolerence_r);
+        describe(ar, pp.maxHeight_r);
+        describe(ar, pp.maxYearlyGrowth_r);
+        describe(ar, pp.maxRootDepth_r);
+        describe(ar, pp.averageFruitWeight_r);
+        describe(ar, pp.seedRatio_r);
+        describe(ar, pp.yearsUntilMaturity_r);
+        describe(ar, pp.vegetativeMaturity_r);
+        describe(ar, pp.maxAge_r);
+        describe(ar, pp.leafFallPeriod_r);
+    }
+
+    template <class Archive> void describe(Archive& ar, PlantVisualProperties& vp)
+    {
+        ar.value(vp.ID);
+        ar.value(vp.name);
+        ar.value(vp.name_plural);
+        ar.value(vp.seedname);
+        ar.value(vp.seedname_plural);
+        ar.value(vp.icon_sprout);
+        ar.value(vp.icon_vegetative);
+        ar.value(vp.icon_mature);
+        ar.value(vp.isCover);
+        ar.value(vp.whiteBackground);
+        describe(ar, vp.color1);
+        describe(ar, vp.color2);
+    }
+}
+
+bool ALMANAC::writeSpeciesCatalog(const std::string& filename, const unsigned int& sourceHash, const std::vector<MasterPlantProperties>& species, const std::map<std::string, PlantVisualProperties>& visuals)
+{
+    CatalogWriter writer;
+    writer.buffer.append(catalogMagic, sizeof(catalogMagic));
+    writer.raw(speciesCatalogVersion);
+    writer.raw(sourceHash);
+    writer.raw((unsigned int)species.size());
+    for (MasterPlantProperties pp : species)
+        describe(writer, pp);
+    writer.raw((unsigned int)visuals.size());
+    for (auto entry : visuals)
+        describe(writer, entry.second);
+
+    // Written next to it and renamed over it, so a run reading it never sees half a catalog.
+    const std::string partial = filename + ".partial";
+    {
+        std::ofstream file(partial.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.write(writer.buffer.data(), writer.buffer.size()))
+            return false;
+    }
+    std::remove(filename.c_str());
+    return std::rename(partial.c_str(), filename.c_str()) == 0;
+}
+
+bool ALMANAC::readSpeciesCatalog(const std::string& filename, const unsigned int& sourceHash, std::vector<MasterPlantProperties>& species, std::map<std::string, PlantVisualProperties>& visuals)
+{
+    MappedFile file;
+    if (!file.open(filename) || file.size() < sizeof(catalogMagic) || memcmp(file.data(), catalogMagic, sizeof(catalogMagic)) != 0)
+        return false;
+
+    CatalogReader reader(file.data() + sizeof(catalogMagic), file.size() - sizeof(catalogMagic));
+    unsigned int version = 0, hash = 0;
+    reader.raw(version);
+    reader.raw(hash);
+    if (!reader.ok || version != speciesCatalogVersion || hash != sourceHash)
+        return false;
+
+    unsigned int count = 0;
+    reader.raw(count);
+    std::vector<MasterPlantProperties> readSpecies;
+    for (unsigned int counter = 0; counter < count && reader.ok; counter++)
+    {
+        MasterPlantProperties pp = MasterPlantProperties();
+        describe(reader, pp);
+        readSpecies.push_back(pp);
+    }
+    reader.raw(count);
+    std::map<std::string, PlantVisualProperties> readVisuals;
+    for (unsigned int counter = 0; counter < count && reader.ok; counter++)
+    {
+        PlantVisualProperties vp;
+        describe(reader, vp);
+        readVisuals[vp.ID] = vp;
+    }
+    if (!reader.ok || reader.next != reader.end)
+        return false;
+
+    species.swap(readSpecies);
+    visuals.swap(readVisuals);
+    return true;
+}
+
+unsigned int ALMANAC::hashCatalogSource(const std::string& text, const unsigned int& hash)
+{
+    unsigned int out = hash;
+    for (unsigned char c : text)
+    {
+        out ^= c;
+        out *= 16777619u;
+    }
+    return out;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include "plantproperties.h"
+#include <string>
+#include <vector>
+#include <map>
+
+namespace ALMANAC
+{
+    const unsigned int speciesCatalogVersion = 1; // Goes up whenever what is stored for a species changes.
+
+    /**
+    The plant dictionary compiled to a binary file, so starting up needs no JSON parsing. Every field of the species
+    and visual properties is stored as is, and reading it back gives the same dictionary. It keeps a hash of the
+    JSON it was compiled from and is only read while that still matches, so editing the JSON makes it stale.
+    speciesID and lifeForm aren't stored, the dictionary sets them the same way for both.
+    **/
+    bool writeSpeciesCatalog(const std::string& filename, const unsigned int& sourceHash, const std::vector<MasterPlantProperties>& species, const std::map<std::string, PlantVisualProperties>& visuals);
+    // False, with species and visuals left alone, if the file is missing, stale, from another version or damaged.
+    bool readSpeciesCatalog(const std::string& filename, const unsigned int& sourceHash, std::vector<MasterPlantProperties>& species, std::map<std::string, PlantVisualProperties>& visuals);
+    unsigned int hashCatalogSource(const std::string& text, const unsigned int& hash = 2166136261u); // FNV-1a. Pass the last hash to chain files.
+}
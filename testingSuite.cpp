@@ -1,6 +1,10 @@
 #include "testingSuite.h"
 #include "plantDictionary.h"
 #include "utility_visual.h"
+#include <cmath>
+#include <algorithm>
+#include <cfloat>
+#include <random>
 
 using namespace ALMANAC;
 
@@ -34,7 +38,7 @@ void Tests::perPlantingDates()
         auto plant = soilg.ref(0, 0).plants.back();
         batchFile << startDate << "\t" << plant.getBiomassStruct() << "\t" << plant.getBiomassStruct().flowerAndfruits << "\t";
 
-        plant.createSeeds(WeatherCopy.getDataBundle().date);
+        plant.createSeeds();
         batchFile << plant.seedlist.size() << "\n";
 
         cout << counter << " ";
@@ -121,7 +125,7 @@ void Tests::singlePlant(const int daysToRun, const std::string& plantname, Month
             << "\t" << plant.getInduction() << "\t" << plant.getHU() << "\n";
     }
 
-    sg.ref(0, 0).plants.back().createSeeds(WeatherModule.getMonth());
+    sg.ref(0, 0).plants.back().createSeeds();
 
     auto seeds = sg.ref(0, 0).plants.back().seedlist;
 
@@ -129,7 +133,7 @@ void Tests::singlePlant(const int daysToRun, const std::string& plantname, Month
     for (auto seed : seeds)
     {
         seedcounter++;
-        cout << "Seed " << seedcounter << " biomass: " << seed.seedBiomass * 1000 << "g\n";
+        cout << "Seed " << seedcounter << " biomass: " << seed * 1000 << "g\n";
     }
 
 
@@ -218,7 +222,7 @@ void Tests::multiplePlants(const int daysToRun, const std::vector<std::string>&
         }
 
         if (discardSeeds)
-            sg.ref(0, 0).seeds.clear();
+            sg.clearSeeds(0, 0);
 
 
         if (sg.radPerPlant.size() < plantnames.size())
@@ -234,7 +238,7 @@ void Tests::multiplePlants(const int daysToRun, const std::vector<std::string>&
         }
         logs << "\n";
 
-        numseeds << sg.ref(0,0).items.size() << "\n";
+        numseeds << sg.ref(0,0).getItemCount() << "\n";
 
         if (sg.ref(0, 0).plants.size() == plantnames.size())
             LAIlog << sg.ref(0, 0).plants.back().getLAI() << "\t" << sg.ref(0, 0).plants.back().getREG() << "\n";
@@ -245,7 +249,7 @@ void Tests::multiplePlants(const int daysToRun, const std::vector<std::string>&
         soilLayers = sg.ref(0, 0).getLayers();
         Nlog << WeatherModule.getDataBundle().date;
         for (auto it : soilLayers)
-            Nlog << "\t" << it.nitrates;
+            Nlog << "\t" << it.getNitrates();
         Nlog << "\n";            
     }
 
@@ -255,7 +259,7 @@ void Tests::multiplePlants(const int daysToRun, const std::vector<std::string>&
 
     if (sg.ref(0, 0).plants.size() != 0)
     {
-        sg.ref(0, 0).plants.back().createSeeds(WeatherModule.getMonth());
+        sg.ref(0, 0).plants.back().createSeeds();
 
         auto seeds = sg.ref(0, 0).plants.back().seedlist;
 
@@ -263,7 +267,7 @@ void Tests::multiplePlants(const int daysToRun, const std::vector<std::string>&
         for (auto seed : seeds)
         {
             seedcounter++;
-            cout << "Seed " << seedcounter << " biomass: " << seed.seedBiomass * 1000 << "g\n";
+            cout << "Seed " << seedcounter << " biomass: " << seed * 1000 << "g\n";
         }
     }   
     else
@@ -287,4 +291,139 @@ void Tests::multiplePlants(const int daysToRun, const std::vector<std::string>&
 
     cin.ignore(1);
     return;
+}
+
+bool Tests::batchedPlants(const int daysToRun, const int mapSize, const std::string& plantname, const double tolerance)
+{
+    Weather WeatherModule(true);
+    SoilGrid scalar(mapSize, mapSize, 1), batched(mapSize, mapSize, 1); // Same seed, same map.
+    batched.setBatchedPlants(true);
+    scalar.initGridWithPlant(plantname);
+    batched.initGridWithPlant(plantname);
+
+    for (int counter = 0; counter < daysToRun; counter++)
+    {
+        WeatherModule.step();
+        scalar.stepAll(WeatherModule.getDataBundle());
+        batched.stepAll(WeatherModule.getDataBundle());
+    }
+
+    auto differs = [tolerance](const double& a, const double& b) { return std::abs(a - b) > tolerance * std::max(std::abs(a), std::abs(b)); };
+    int plants = 0, mismatches = 0;
+    for (int y = 0; y < mapSize; y++)
+    for (int x = 0; x < mapSize; x++)
+    {
+        auto& scalarPlants = scalar.ref(x, y).plants;
+        auto& batchedPlants = batched.ref(x, y).plants;
+        if (scalarPlants.size() != batchedPlants.size())
+        {
+            cout << "(" << x << ", " << y << "): " << scalarPlants.size() << " plants unbatched, " << batchedPlants.size() << " batched\n";
+            mismatches++;
+            continue;
+        }
+        for (unsigned int counter = 0; counter < scalarPlants.size(); counter++)
+        {
+            BasePlant& left = scalarPlants[counter];
+            BasePlant& right = batchedPlants[counter];
+            plants++;
+            if (differs(left.getBiomass(), right.getBiomass()) || differs(left.getLAI(), right.getLAI()) || differs(left.getHU(), right.getHU()))
+            {
+                cout << "(" << x << ", " << y << ") plant " << counter << ": biomass " << left.getBiomass() << " / " << right.getBiomass()
+                    << ", LAI " << left.getLAI() << " / " << right.getLAI() << ", HU " << left.getHU() << " / " << right.getHU() << "\n";
+                mismatches++;
+            }
+        }
+    }
+
+    cout << plants << " plants compared, " << mismatches << " mismatches\n";
+    return mismatches == 0;
+}
+
+bool Tests::vectorSoilColumns(const int cellCount, const int maxUlps)
+{
+    if (!SoilColumns::usesAVX2())
+    {
+        cout << "No AVX2 percolation in this build or on this CPU, nothing to compare.\n";
+        return true;
+    }
+
+    const int layers = 4;
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    SoilColumns vector;
+    vector.resize(cellCount, layers);
+    for (int layer = 0; layer < layers; layer++)
+    for (int cell = 0; cell < cellCount; cell++)
+    {
+        const int s = vector.slot(cell, layer);
+        vector.fieldCapacity[s] = 20 + 80 * unit(gen);
+        vector.saturatedMoisture[s] = vector.fieldCapacity[s] * (1.2 + unit(gen));
+        vector.water[s] = vector.saturatedMoisture[s] * unit(gen); // About a third of them below field capacity.
+        vector.travelTime[s] = 0.01 + 2 * unit(gen);
+        vector.nitrates[s] = 10 * unit(gen);
+    }
+    for (int cell = 0; cell < cellCount; cell++)
+        vector.slope[cell] = cell % 16 ? 200 * unit(gen) : 0; // Some flat cells, which have no lateral flow.
+    SoilColumns scalar = vector;
+
+    for (int layer = 0; layer < layers; layer++)
+    {
+        vector.percolateAndLateral(layer, 0, cellCount);
+        scalar.percolateAndLateralScalar(layer, 0, cellCount);
+    }
+
+    // 1 - exp() of a small exponent cancels most of its digits, so differences are in ulps of the water or nitrates the flows came out of.
+    double worst = 0;
+    int failures = 0;
+    auto ulps = [&](const double& a, const double& b, const double& scale)
+    {
+        const double difference = scale > 0 ? std::abs(a - b) / (scale * DBL_EPSILON) : std::abs(a - b);
+        if (!(difference <= maxUlps)) // NaN fails as well.
+            failures++;
+        worst = std::max(worst, difference);
+    };
+    for (int layer = 0; layer < layers; layer++)
+    for (int cell = 0; cell < cellCount; cell++)
+    {
+        const int s = scalar.slot(cell, layer);
+        const double water = scalar.water[s];
+        const double nitrates = scalar.nitrates[s] + scalar.movedNitrates[s];
+        ulps(vector.percolateDown[s], scalar.percolateDown[s], water);
+        ulps(vector.percolateUp[s], scalar.percolateUp[s], water);
+        ulps(vector.lateral[s], scalar.lateral[s], water);
+        ulps(vector.previousWater[s], scalar.previousWater[s], water);
+        ulps(vector.movedNitrates[s], scalar.movedNitrates[s], nitrates);
+        ulps(vector.nitrates[s], scalar.nitrates[s], nitrates);
+    }
+
+    cout << "AVX2 and scalar percolation differ by at most " << worst << " ulps, " << failures << " values past " << maxUlps << "\n";
+    return failures == 0;
+}
+
+bool Tests::surfaceFlowConservation(const int mapSize, const double tolerance)
+{
+    bool conserved = true;
+    const double durations[] = { 1, 5, 30 };
+    for (double duration : durations)
+    {
+        SoilGrid sg(mapSize, mapSize, 1);
+        double before = 0;
+        for (int y = 0; y < mapSize; y++)
+        for (int x = 0; x < mapSize; x++)
+        {
+            sg.ref(x, y).surfaceWater = (x + y * mapSize) % 7 ? 0 : 1; // 1 mm puddles here and there.
+            before += sg.get(x, y).surfaceWater;
+        }
+
+        int substeps = sg.routeSurfaceFlow(WeatherData(), duration);
+
+        double after = 0;
+        for (int y = 0; y < mapSize; y++)
+        for (int x = 0; x < mapSize; x++)
+            after += sg.get(x, y).surfaceWater;
+        cout << duration << " days in " << substeps << " substeps: " << before << " mm before, " << after << " mm after\n";
+        if (!(std::abs(after - before) <= tolerance * before))
+            conserved = false;
+    }
+    return conserved;
 }
\ No newline at end of file
@@ -15,6 +15,15 @@ namespace ALMANAC
         static void perPlantingDates(); // Runs the simulation for each plant, changing the start sim day by one day for the whole year.
         static void singlePlant(const int daysToRun = 250, const std::string& plantname = "Pea",  Month startDate = Month(APRIL, 12));
         static void multiplePlants(const int daysToRun = 250, const std::vector<std::string>& plantnames = {string("Pea")}, Month startDate = Month(APRIL, 12));
+        // Runs the same map with and without SoilGrid::setBatchedPlants() and compares every plant's biomass, LAI and heat units.
+        // True if they all match to within tolerance, relative to the larger of the two.
+        static bool batchedPlants(const int daysToRun = 360, const int mapSize = 32, const std::string& plantname = "fescue grass", const double tolerance = 1e-9);
+        // Routes puddles over the map for a few durations, some longer than a day, and checks no surface water is made or lost.
+        // Halo cells are infinitely tall, so the map is a closed basin. True if the totals match to within tolerance.
+        static bool surfaceFlowConservation(const int mapSize = 32, const double tolerance = 1e-9);
+        // Runs SoilColumns' AVX2 percolation and the one cell at a time version on the same random layers and compares them.
+        // True if they agree to within maxUlps, or if this build or CPU has no AVX2 version to compare.
+        static bool vectorSoilColumns(const int cellCount = 4096, const int maxUlps = 4);
     };
     
 }
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "threadPool.h"
+
+using namespace ALMANAC;
+
+ThreadPool::ThreadPool(const int& workers)
+: nextJob(0), jobCount(0), finished(0), generation(0), stopping(false)
+{
+    resize(workers);
+}
+
+ThreadPool::~ThreadPool()
+{
+    stop();
+}
+
+void ThreadPool::resize(const int& workers)
+{
+    stop();
+    stopping = false;
+    for (int counter = 0; counter < workers; counter++)
+        threads.push_back(std::thread(&ThreadPool::work, this));
+}
+
+int ThreadPool::size()
+{
+    return threads.size();
+}
+
+void ThreadPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& thread : threads)
+        thread.join();
+    threads.clear();
+}
+
+void ThreadPool::run(const int& jobs, const std::function<void(int)>& job)
+{
+    if (threads.empty())
+    {
+        for (int counter = 0; counter < jobs; counter++)
+            job(counter);
+        return;
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+    current = job;
+    nextJob = 0;
+    jobCount = jobs;
+    finished = 0;
+    generation++;
+    wake.notify_all();
+
+    doJobs(guard); // The caller helps out instead of idling.
+    done.wait(guard, [this]{ return finished == jobCount; });
+    current = nullptr;
+}
+
+void ThreadPool::work()
+{
+    unsigned int seen = 0;
+    std::unique_lock<std::mutex> guard(lock);
+    while (true)
+    {
+        wake.wait(guard, [this, &seen]{ return stopping || generation != seen; });
+        if (stopping)
+            return;
+        seen = generation;
+        doJobs(guard);
+    }
+}
+
+void ThreadPool::doJobs(std::unique_lock<std::mutex>& guard)
+{
+    while (nextJob < jobCount)
+    {
+        int job = nextJob++;
+        guard.unlock();
+        current(job);
+        guard.lock();
+        finished++;
+        if (finished == jobCount)
+            done.notify_all();
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace ALMANAC
+{
+    /**
+    A small fixed-size pool of worker threads. run() hands out job indices to the workers
+    and the calling thread, and only returns once every job is finished, so it doubles as a barrier.
+    With zero workers everything simply runs on the calling thread, in order.
+    **/
+    class ThreadPool
+    {
+    public:
+        ThreadPool(const int& workers = 0);
+        ~ThreadPool();
+
+        void resize(const int& workers); // Must not be called while run() is in progress.
+        int size();
+        void run(const int& jobs, const std::function<void(int)>& job); // Calls job(0) .. job(jobs - 1).
+
+    private:
+        ThreadPool(const ThreadPool&);
+        ThreadPool& operator=(const ThreadPool&);
+
+        void work();
+        void doJobs(std::unique_lock<std::mutex>& guard);
+        void stop();
+
+        std::vector<std::thread> threads;
+        std::mutex lock;
+        std::condition_variable wake, done;
+        std::function<void(int)> current;
+        int nextJob, jobCount, finished;
+        unsigned int generation; // Bumped once per run(), so sleeping workers know there is new work.
+        bool stopping;
+    };
+}